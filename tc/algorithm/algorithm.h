@@ -47,6 +47,7 @@
 #include "partition_iterator.h"
 #include "partition_range.h"
 #include "size_linear.h"
+#include "small_sort.h"
 
 
 #include <boost/preprocessor/repetition/enum.hpp>
@@ -58,6 +59,7 @@
 #include <boost/multi_index/ordered_index_fwd.hpp>
 #include <boost/intrusive/set.hpp>
 
+#include <array>
 #include <type_traits>
 #include <set>
 #include <map>
@@ -193,6 +195,20 @@ namespace tc {
 			static_assert( std::is_lvalue_reference<Rng>::value );
 			rng.sort( std::forward<Less>(less) );
 		} else {
+			if constexpr( tc::random_access_range<Rng> && std::is_lvalue_reference<decltype(*tc::begin(rng))>::value ) {
+				// Small ranges: a sorting network if the size is known at compile time and the elements are compare-exchanged
+				// branchless, insertion sort otherwise. Both work in constant expressions.
+				if constexpr( tc::has_constexpr_size<Rng> ) {
+					if constexpr( small_sort_detail::c_bSortingNetwork<std::remove_reference_t<decltype(*tc::begin(rng))>, tc::constexpr_size<Rng>::value> ) {
+						small_sort_detail::sorting_network<tc::constexpr_size<Rng>::value>(tc::begin(rng), less);
+						return;
+					}
+				}
+				if( tc::end(rng) - tc::begin(rng) <= tc::explicit_cast<std::ptrdiff_t>(small_sort_detail::c_nMaxInsertionSortSize) ) {
+					small_sort_detail::insertion_sort(tc::begin(rng), tc::end(rng), less);
+					return;
+				}
+			}
 #ifdef __clang__ // xcode12 does not support constexpr std::sort
 			if(std::is_constant_evaluated()) {
 				constexpr_sort_inplace_detail::constexpr_sort_inplace(tc::begin(rng), tc::end(rng), less);
@@ -211,6 +227,104 @@ namespace tc {
 		std::stable_sort(tc::begin(rng), tc::end(rng), std::forward<Less>(less));
 	}
 
+	DEFINE_TAG_TYPE(cached_key_tag)
+
+	namespace sort_cached_key_detail {
+		template<typename Key>
+		struct key_position final {
+			template<typename K>
+			key_position(K&& key, std::size_t n) noexcept
+				: m_key(std::forward<K>(key))
+				, m_n(n)
+			{}
+
+			Key m_key;
+			std::size_t m_n; // position in the original range
+		};
+
+		// Integral keys compared by tc::fn_less are sorted by LSD radix sort, which is stable.
+		template<typename Key, typename Less>
+		inline constexpr bool c_bRadix = std::is_integral<Key>::value && !std::is_same<Key, bool>::value && std::is_same<tc::decay_t<Less>, tc::fn_less>::value;
+
+		// Below this size, std::sort beats the fixed cost of the radix passes.
+		inline constexpr std::size_t c_nMinRadixSize = 256;
+
+		template<typename Key>
+		void radix_sort_inplace(tc::vector<key_position<Key>>& veckp) noexcept {
+			using unsigned_t = std::make_unsigned_t<Key>;
+			auto const Digit = [](Key const key, int const nByte) noexcept -> std::size_t {
+				auto n = static_cast<unsigned_t>(key);
+				if constexpr( std::is_signed<Key>::value ) {
+					n ^= unsigned_t(1) << (std::numeric_limits<unsigned_t>::digits - 1); // order negative before positive
+				}
+				return (n >> (8 * nByte)) & 0xff;
+			};
+			tc::vector<key_position<Key>> veckpBuffer(tc::size(veckp), key_position<Key>(Key(), 0)); // every pass overwrites all elements
+			for( int nByte = 0; nByte < tc::explicit_cast<int>(sizeof(Key)); ++nByte ) {
+				std::array<std::size_t, 256> anOffset = {};
+				for( auto const& kp : veckp ) ++anOffset[Digit(kp.m_key, nByte)];
+				if( tc::size(veckp) == anOffset[Digit(tc::front(veckp).m_key, nByte)] ) continue; // all keys agree in this byte
+				std::size_t nOffset = 0;
+				for( auto& n : anOffset ) {
+					nOffset += std::exchange(n, nOffset);
+				}
+				for( auto const& kp : veckp ) {
+					veckpBuffer[anOffset[Digit(kp.m_key, nByte)]++] = kp;
+				}
+				tc::swap(veckp, veckpBuffer);
+			}
+		}
+
+		// Returns the positions of the elements of rng in the order sorted by their keys proj(element), evaluating proj once per element.
+		template<bool bStable, typename Rng, typename Proj, typename Less>
+		tc::vector<std::size_t> sorted_permutation(Rng const& rng, Proj const& proj, Less const& less) noexcept {
+			using key_t = tc::decay_t<decltype(tc::invoke(proj, std::declval<tc::range_value_t<Rng const&> const&>()))>;
+			tc::vector<key_position<key_t>> veckp;
+			if constexpr( tc::has_size<Rng const&> ) {
+				tc::cont_reserve(veckp, tc::size(rng));
+			}
+			tc::for_each(rng, [&](auto const& t) noexcept {
+				tc::cont_emplace_back(veckp, tc::invoke(proj, t), tc::size(veckp));
+			});
+			if constexpr( c_bRadix<key_t, Less> ) {
+				if( c_nMinRadixSize <= tc::size(veckp) ) {
+					radix_sort_inplace(veckp);
+					return tc::make_vector(tc::transform(veckp, tc_member(.m_n)));
+				}
+			}
+			// Positions are unique, so breaking ties by position makes the unstable sort stable, without the buffer of std::stable_sort.
+			tc::sort_inplace(veckp, [&](key_position<key_t> const& lhs, key_position<key_t> const& rhs) noexcept {
+				if constexpr( bStable ) {
+					return less(lhs.m_key, rhs.m_key) || (!less(rhs.m_key, lhs.m_key) && lhs.m_n < rhs.m_n);
+				} else {
+					return less(lhs.m_key, rhs.m_key);
+				}
+			});
+			return tc::make_vector(tc::transform(veckp, tc_member(.m_n)));
+		}
+
+		// Moves the element at position vecn[i] of the random-access range rng to position i, following the cycles of the permutation.
+		// Each element is moved once, plus one temporary per cycle. Destroys vecn.
+		template<typename Rng>
+		void permute_inplace(Rng&& rng, tc::vector<std::size_t>& vecn) noexcept {
+			auto const it = tc::begin(rng);
+			for( std::size_t i = 0; i < tc::size(vecn); ++i ) {
+				if( vecn[i] != i ) {
+					tc::range_value_t<Rng&> t = tc_move_always(it[i]);
+					for( std::size_t j = i;; ) {
+						auto const nSource = std::exchange(vecn[j], j);
+						if( nSource == i ) {
+							it[j] = tc_move(t);
+							break;
+						}
+						it[j] = tc_move_always(it[nSource]);
+						j = nSource;
+					}
+				}
+			}
+		}
+	}
+
 	namespace no_adl {
 		template<typename Rng, bool bStable>
 		struct [[nodiscard]] sorted_index_adaptor final
@@ -232,16 +346,22 @@ namespace tc {
 
 			using difference_type = typename decltype(m_vecidx)::difference_type;
 
-			template<typename LessOrComp>
-			explicit sorted_index_adaptor(Rng&& rng, LessOrComp lessorcomp) noexcept
-				: tc::range_adaptor_base_range<Rng>(tc::aggregate_tag, std::forward<Rng>(rng))
-			{
+		private:
+			void fill_indices() & noexcept {
 				if constexpr (tc::has_size<Rng>) {
 					tc::cont_reserve(m_vecidx, tc::size(this->base_range()));
 				}
 				for(auto idx=this->base_begin_index(); !tc::at_end_index(this->base_range(), idx); tc::increment_index(this->base_range(), idx)) {
 					tc::cont_emplace_back(m_vecidx, idx);
 				}
+			}
+
+		public:
+			template<typename LessOrComp>
+			explicit sorted_index_adaptor(Rng&& rng, LessOrComp lessorcomp) noexcept
+				: tc::range_adaptor_base_range<Rng>(tc::aggregate_tag, std::forward<Rng>(rng))
+			{
+				fill_indices();
 				tc::sort_inplace(
 					m_vecidx,
 					[&](auto const& idxLhs, auto const& idxRhs ) noexcept -> bool {
@@ -266,6 +386,16 @@ namespace tc {
 				);
 			}
 
+			// Evaluates proj once per element instead of dereferencing and projecting both sides of every comparison.
+			template<typename Proj, typename Less>
+			explicit sorted_index_adaptor(tc::cached_key_tag_t, Rng&& rng, Proj const& proj, Less const& less) noexcept
+				: tc::range_adaptor_base_range<Rng>(tc::aggregate_tag, std::forward<Rng>(rng))
+			{
+				fill_indices();
+				auto vecn = sort_cached_key_detail::sorted_permutation<bStable>(this->base_range(), proj, less);
+				sort_cached_key_detail::permute_inplace(m_vecidx, vecn);
+			}
+
 			sorted_index_adaptor(sorted_index_adaptor&& rng) noexcept requires tc::is_index_valid_for_move_constructed_range<Rng>::value // reference_or_value is movable for const Rng as well
 				: range_adaptor_base_range<Rng>(tc_move(rng))
 				, m_vecidx(tc_move(rng).m_vecidx)
@@ -342,6 +472,35 @@ namespace tc {
 		return tc::sorted_index_adaptor<Rng, true/*bStable*/>(std::forward<Rng>(rng), std::forward<Comp>(comp));
 	}
 	
+	// Like tc::sort(rng, tc::projected(less, proj)), but computes the keys proj(element) once into a compact array and sorts that,
+	// by radix sort if the keys are integral and less is tc::fn_less. Pays off when proj is expensive, e.g., builds strings.
+	template<typename Rng, typename Proj, typename Less = tc::fn_less>
+	[[nodiscard]] auto sort_by_cached_key(Rng&& rng, Proj const& proj, Less const& less = Less()) noexcept {
+		return tc::sorted_index_adaptor<Rng, false/*bStable*/>(tc::cached_key_tag, std::forward<Rng>(rng), proj, less);
+	}
+
+	// Like tc::sort_by_cached_key, but keeps the order of elements with equal keys.
+	template<typename Rng, typename Proj, typename Less = tc::fn_less>
+	[[nodiscard]] auto stable_sort_by_cached_key(Rng&& rng, Proj const& proj, Less const& less = Less()) noexcept {
+		return tc::sorted_index_adaptor<Rng, true/*bStable*/>(tc::cached_key_tag, std::forward<Rng>(rng), proj, less);
+	}
+
+	// Like tc::sort_inplace(rng, tc::projected(less, proj)), but computes each key once, sorts (key, position) pairs
+	// and then moves each element once into its place.
+	template<typename Rng, typename Proj, typename Less = tc::fn_less>
+	void sort_inplace_by_cached_key(Rng&& rng, Proj const& proj, Less const& less = Less()) noexcept {
+		static_assert( tc::random_access_range<Rng> );
+		auto vecn = sort_cached_key_detail::sorted_permutation<false/*bStable*/>(rng, proj, less);
+		sort_cached_key_detail::permute_inplace(rng, vecn);
+	}
+
+	template<typename Rng, typename Proj, typename Less = tc::fn_less>
+	void stable_sort_inplace_by_cached_key(Rng&& rng, Proj const& proj, Less const& less = Less()) noexcept {
+		static_assert( tc::random_access_range<Rng> );
+		auto vecn = sort_cached_key_detail::sorted_permutation<true/*bStable*/>(rng, proj, less);
+		sort_cached_key_detail::permute_inplace(rng, vecn);
+	}
+
 	namespace no_adl {
 		template< typename Rng >
 		struct [[nodiscard]] untransform_adaptor
@@ -13,6 +13,7 @@
 #include "../range/join_adaptor.h"
 #include "../range/repeat_n.h"
 #include "../string/spirit_algorithm.h"
+#include "../string/format.h"
 #include "interleave_ranges.h"
 
 #include <random>
@@ -356,6 +357,111 @@ UNITTESTDEF(sort_test) {
 	_ASSERT(tc::equal(rngpairnnSorted, vecpairnn2));
 }
 
+UNITTESTDEF(sort_by_cached_key_test) {
+	tc::vector<std::pair<int, int>> vecpairnn1{{5,0}, {3,0}, {0,0}, {6,0}, {1,0}, {5,1}, {1,1}, {5,2}, {3,1}, {0,1}, {0,2}, {6,1}};
+	tc::vector<std::pair<int, int>> vecpairnn2{{0,0}, {0,1}, {0,2}, {1,0}, {1,1}, {3,0}, {3,1}, {5,0}, {5,1}, {5,2}, {6,0}, {6,1}};
+	int nProjections = 0;
+	auto const first = [&](auto const& pairnn) noexcept { ++nProjections; return pairnn.first; };
+	_ASSERT(tc::equal(tc::stable_sort_by_cached_key(vecpairnn1, first), vecpairnn2));
+	_ASSERTEQUAL(nProjections, 12);
+	_ASSERT(tc::equal(tc::sort_by_cached_key(vecpairnn1, first), vecpairnn2, tc::projected(tc::fn_equal_to(), tc_member(.first))));
+	_ASSERT(tc::equal(tc::sort_by_cached_key(tc::vector<int>{3,7,1,9,2,5,8,4,6,0}, [](int n) noexcept { return -n; }, tc::fn_greater()), tc::iota(0, 10)));
+
+	auto vecpairnn3 = vecpairnn1;
+	tc::stable_sort_inplace_by_cached_key(vecpairnn3, first);
+	_ASSERTEQUAL(vecpairnn3, vecpairnn2);
+
+	// String keys, compared by a projection which allocates.
+	tc::vector<int> vecn{12, 3, 100, 7, 25};
+	tc::sort_inplace_by_cached_key(vecn, [](int n) noexcept { return tc::make_str(tc::as_dec(n)); }, tc::lessfrom3way(tc::fn_lexicographical_compare_3way()));
+	_ASSERTEQUAL(vecn, (tc::vector<int>{100, 12, 25, 3, 7}));
+
+	// Radix sort of integral keys, including negative ones.
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	std::uniform_int_distribution<std::int64_t> dist(-1000000, 1000000);
+	tc::vector<std::pair<std::int64_t, int>> vecpairnn;
+	for( int i = 0; i < 2000; ++i ) {
+		tc::cont_emplace_back(vecpairnn, dist(gen) / (i % 2 ? 1 : 1000), i);
+	}
+	auto vecpairnnExpected = vecpairnn;
+	tc::stable_sort_inplace(vecpairnnExpected, tc::projected(tc::fn_less(), tc_member(.first)));
+	_ASSERT(tc::equal(tc::stable_sort_by_cached_key(vecpairnn, tc_member(.first)), vecpairnnExpected));
+	tc::sort_inplace_by_cached_key(vecpairnn, tc_member(.first));
+	_ASSERTEQUAL(vecpairnn, vecpairnnExpected); // radix sort is stable
+	tc::sort_inplace_by_cached_key(vecpairnn, tc_member(.second), tc::fn_greater());
+	_ASSERT(tc::equal(tc::transform(vecpairnn, tc_member(.second)), tc::reverse(tc::iota(0, 2000))));
+
+	// Comparison sort with many ties; the stable variants break them by position.
+	auto vecpairnnExpectedGreater = vecpairnn;
+	tc::stable_sort_inplace(vecpairnnExpectedGreater, tc::projected(tc::fn_greater(), [](auto const& pairnn) noexcept { return pairnn.first / 100000; }));
+	_ASSERT(tc::equal(tc::stable_sort_by_cached_key(vecpairnn, [](auto const& pairnn) noexcept { return pairnn.first / 100000; }, tc::fn_greater()), vecpairnnExpectedGreater));
+	tc::stable_sort_inplace_by_cached_key(vecpairnn, [](auto const& pairnn) noexcept { return pairnn.first / 100000; }, tc::fn_greater());
+	_ASSERTEQUAL(vecpairnn, vecpairnnExpectedGreater);
+}
+
+static_assert(tc::small_sort_detail::c_nComparators<2> == 1);
+static_assert(tc::small_sort_detail::c_nComparators<3> == 3);
+static_assert(tc::small_sort_detail::c_nComparators<4> == 5);
+static_assert(tc::small_sort_detail::c_nComparators<5> == 9);
+static_assert(tc::small_sort_detail::c_nComparators<6> == 12);
+static_assert(tc::small_sort_detail::c_nComparators<7> == 16);
+static_assert(tc::small_sort_detail::c_nComparators<8> == 19);
+static_assert(tc::small_sort_detail::c_bSortingNetwork<int, 32>);
+static_assert(!tc::small_sort_detail::c_bSortingNetwork<int, 33>);
+static_assert(!tc::small_sort_detail::c_bSortingNetwork<tc::string<char>, 2>);
+static_assert([]() noexcept {
+	auto an = tc::make_array(tc::aggregate_tag, 5, 3, 9, 1, 7);
+	tc::sort_inplace(an);
+	tc::vector<int> vecn{8, 2, 6};
+	tc::sort_inplace(vecn);
+	return an == tc::make_array(tc::aggregate_tag, 1, 3, 5, 7, 9) && tc::equal(vecn, tc::make_array(tc::aggregate_tag, 2, 6, 8));
+}());
+
+namespace {
+	template<std::size_t N>
+	void test_sorting_network(std::mt19937& gen) noexcept {
+		// By the 0-1 principle, a network sorts all inputs if it sorts all sequences of 0 and 1.
+		if constexpr( N <= 16 ) {
+			for( std::size_t nBits = 0; nBits < std::size_t(1) << N; ++nBits ) {
+				std::array<int, N> an;
+				for( std::size_t i = 0; i < N; ++i ) an[i] = (nBits >> i) & 1;
+				tc::sort_inplace(an);
+				_ASSERT(tc::is_sorted(an));
+			}
+		}
+		std::uniform_int_distribution<int> dist(0, 20);
+		for( int i = 0; i < 100; ++i ) {
+			std::array<tc::string<char>, N> astr;
+			for( auto& str : astr ) str = tc::make_str<char>(tc::as_dec(dist(gen)));
+			auto vecstrExpected = tc::make_vector(astr);
+			std::sort(tc::begin(vecstrExpected), tc::end(vecstrExpected));
+			tc::sort_inplace(astr, tc::fn_greater());
+			_ASSERT(tc::equal(astr, tc::reverse(vecstrExpected)));
+		}
+	}
+}
+
+UNITTESTDEF(small_sort_test) {
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	[&]<std::size_t... N>(std::index_sequence<N...>) noexcept {
+		(test_sorting_network<N>(gen), ...);
+	}(std::make_index_sequence<tc::small_sort_detail::c_nMaxSortingNetworkSize + 2>());
+
+	std::uniform_int_distribution<int> dist(-50, 50);
+	for( int n = 0; n <= 20; ++n ) {
+		tc::vector<int> vecn;
+		tc::vector<tc::string<char>> vecstr;
+		for( int i = 0; i < n; ++i ) {
+			tc::cont_emplace_back(vecn, dist(gen));
+			tc::cont_emplace_back(vecstr, tc::make_str<char>(tc::as_dec(dist(gen))));
+		}
+		tc::sort_inplace(vecn);
+		_ASSERT(tc::is_sorted(vecn));
+		tc::sort_inplace(vecstr);
+		_ASSERT(tc::is_sorted(vecstr));
+	}
+}
+
 #ifdef __clang__ // remove if std::sort is constexpr in xcode
 UNITTESTDEF(constexpr_sort_test) {
 	std::mt19937 gen; // same sequence of numbers each time for reproducibility
@@ -378,3 +484,25 @@ UNITTESTDEF(constexpr_sort_test) {
 }
 #endif
 }
+
+UNITTESTDEF(static_char_class_test) {
+	static constexpr auto charsetDigit = tc::static_char_class(std::string_view("0123456789"));
+	static_assert( charsetDigit.contains('7') );
+	static_assert( !charsetDigit.contains('a') );
+	static_assert( !charsetDigit.contains('\xff') );
+
+	auto const str = tc::string<char>("2024-10-19");
+	auto it = tc::begin(str);
+	_ASSERT( tc::parse_iterator(it, tc::end(str), +charsetDigit) );
+	_ASSERTEQUAL( it - tc::begin(str), 4 );
+	_ASSERT( tc::equal(tc::find_first_not_of<tc::return_take_before_or_all>(str, charsetDigit), "2024") );
+	_ASSERT( tc::equal(tc::find_first_of<tc::return_drop_before_or_empty>("abc-12", charsetDigit), "12") );
+	_ASSERT( !tc::find_first_of<tc::return_bool>("abc", charsetDigit) );
+
+	static constexpr auto charsetWide = tc::static_char_class(std::u16string_view(u"aé中"));
+	static_assert( charsetWide.contains(u'a') );
+	static_assert( charsetWide.contains(u'é') );
+	static_assert( charsetWide.contains(u'中') );
+	static_assert( !charsetWide.contains(u'丮') );
+	static_assert( !charsetWide.contains(u'ê') );
+}
@@ -0,0 +1,167 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../container/container.h"
+#include "../container/cont_reserve.h"
+#include "../range/subrange.h"
+#include "../range/intersection_adaptor.h"
+#include "../range/union_adaptor.h"
+#include "algorithm.h"
+#include "compare.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace tc {
+	namespace parallel_merge_detail {
+		// Below this size per part, threads cost more than they save.
+		inline constexpr std::size_t c_nMinPartitionSize = 64 * 1024;
+
+		// nPartitions = 0 chooses one part per hardware thread, but not smaller than c_nMinPartitionSize.
+		inline std::size_t partition_count(std::size_t nSize, std::size_t nPartitions) noexcept {
+			if( 0 == nPartitions ) {
+				return tc::max(tc::min(tc::implicit_cast<std::size_t>(std::thread::hardware_concurrency()), nSize / c_nMinPartitionSize), std::size_t(1));
+			} else {
+				return nPartitions;
+			}
+		}
+
+		// Returns nPartitions + 1 monotonic split points (iA, iB) dividing the merged sequence of the sorted ranges rngA and rngB
+		// into parts of about equal size. The split points are found by merge path: binary search along the diagonals
+		// iA + iB = k * (size(rngA) + size(rngB)) / nPartitions of the merge matrix.
+		// Splitting there keeps merge stable. For intersection and difference, bGroupEqual moves each split point back to the first
+		// occurrence of its value in both ranges, so equal elements always fall into the same part, which keeps the multiset semantics.
+		// Merge does not need this, and with long runs of equal elements it would collapse the parts.
+		template<bool bGroupEqual, typename RngA, typename RngB, typename Less>
+		tc::vector<std::pair<std::size_t, std::size_t>> merge_path_partition(RngA const& rngA, RngB const& rngB, Less const& less, std::size_t const nPartitions) noexcept {
+			auto const itA = tc::begin(rngA);
+			auto const itB = tc::begin(rngB);
+			std::size_t const nA = tc::size(rngA);
+			std::size_t const nB = tc::size(rngB);
+			tc::vector<std::pair<std::size_t, std::size_t>> vecpairn;
+			tc::cont_reserve(vecpairn, nPartitions + 1);
+			tc::cont_emplace_back(vecpairn, 0, 0);
+			for( std::size_t k = 1; k < nPartitions; ++k ) {
+				std::size_t const nDiagonal = (nA + nB) * k / nPartitions;
+				// The first nDiagonal merged elements are rngA[0, iA) and rngB[0, nDiagonal - iA). Ties take rngA first.
+				std::size_t iLo = nDiagonal < nB ? 0 : nDiagonal - nB;
+				std::size_t iHi = tc::min(nDiagonal, nA);
+				while( iLo < iHi ) {
+					std::size_t const iMid = iLo + (iHi - iLo) / 2;
+					if( less(tc::as_const(itB[nDiagonal - iMid - 1]), tc::as_const(itA[iMid])) ) {
+						iHi = iMid;
+					} else {
+						iLo = iMid + 1;
+					}
+				}
+				std::size_t const iB = nDiagonal - iLo;
+				std::pair<std::size_t, std::size_t> pairn(iLo, iB);
+				if( bGroupEqual && (iLo < nA || iB < nB) ) {
+					auto const& val = iLo < nA && (nB == iB || !less(tc::as_const(itB[iB]), tc::as_const(itA[iLo]))) ? itA[iLo] : itB[iB];
+					pairn.first = tc::explicit_cast<std::size_t>(tc::iterator::partition_point(itA, itA + nA, [&](auto const& a) noexcept { return less(a, val); }) - itA);
+					pairn.second = tc::explicit_cast<std::size_t>(tc::iterator::partition_point(itB, itB + nB, [&](auto const& b) noexcept { return less(b, val); }) - itB);
+				}
+				tc::cont_emplace_back(vecpairn, pairn);
+			}
+			tc::cont_emplace_back(vecpairn, nA, nB);
+			return vecpairn;
+		}
+
+		// Calls func(i) for 0 <= i < n, each on its own thread. Part 0 runs on the calling thread.
+		template<typename Func>
+		void parallel_for(std::size_t const n, Func const& func) noexcept {
+			tc::vector<std::thread> vecthread;
+			tc::cont_reserve(vecthread, n);
+			for( std::size_t i = 1; i < n; ++i ) {
+				tc::cont_emplace_back(vecthread, [&func, i]() noexcept { func(i); });
+			}
+			func(0);
+			tc::for_each(vecthread, [](std::thread& thread) noexcept { thread.join(); });
+		}
+
+		template<typename Rng>
+		auto slice(Rng const& rng, std::size_t const nBegin, std::size_t const nEnd) noexcept {
+			return tc::make_iterator_range(tc::begin(rng) + nBegin, tc::begin(rng) + nEnd);
+		}
+
+		// Runs fnset on corresponding parts of rngA and rngB in parallel and concatenates the results.
+		template<typename RngA, typename RngB, typename Comp, typename FuncSetOperation>
+		auto parallel_set_operation(RngA const& rngA, RngB const& rngB, Comp const& comp, std::size_t nPartitions, FuncSetOperation fnset) noexcept {
+			static_assert( tc::random_access_range<RngA const> && tc::random_access_range<RngB const> );
+			auto const less = tc::lessfrom3way(std::ref(comp));
+			auto const vecpairn = merge_path_partition</*bGroupEqual*/true>(rngA, rngB, less, partition_count(tc::size(rngA) + tc::size(rngB), nPartitions));
+			auto const nParts = tc::size(vecpairn) - 1;
+
+			using result_t = decltype(tc::make_vector(fnset(slice(rngA, 0, 0), slice(rngB, 0, 0), comp)));
+			tc::vector<result_t> vecvecPart(nParts);
+			parallel_for(nParts, [&](std::size_t i) noexcept {
+				vecvecPart[i] = tc::make_vector(fnset(slice(rngA, vecpairn[i].first, vecpairn[i + 1].first), slice(rngB, vecpairn[i].second, vecpairn[i + 1].second), comp));
+			});
+			if( 1 == nParts ) return tc_move_always(tc::front(vecvecPart));
+
+			tc::vector<std::size_t> vecnOffset(nParts + 1, 0);
+			for( std::size_t i = 0; i < nParts; ++i ) {
+				vecnOffset[i + 1] = vecnOffset[i] + tc::size(vecvecPart[i]);
+			}
+			result_t vecResult;
+			tc::cont_extend(vecResult, tc::back(vecnOffset));
+			parallel_for(nParts, [&](std::size_t i) noexcept {
+				std::move(tc::begin(vecvecPart[i]), tc::end(vecvecPart[i]), tc::begin(vecResult) + vecnOffset[i]);
+			});
+			return vecResult;
+		}
+	}
+
+	// Stable merge of the sorted random-access ranges rngA and rngB into the preallocated output starting at itOut, using nPartitions threads.
+	// Produces the same sequence as tc::merge_range. nPartitions = 0 uses one thread per hardware thread, but fewer for small inputs.
+	// Returns the end of the output.
+	template<typename RngA, typename RngB, typename ItOut, typename Less = tc::fn_less>
+	ItOut parallel_merge(RngA const& rngA, RngB const& rngB, ItOut itOut, Less const less = Less(), std::size_t const nPartitions = 0) noexcept {
+		static_assert( tc::random_access_range<RngA const> && tc::random_access_range<RngB const> );
+		auto const vecpairn = parallel_merge_detail::merge_path_partition</*bGroupEqual*/false>(rngA, rngB, less, parallel_merge_detail::partition_count(tc::size(rngA) + tc::size(rngB), nPartitions));
+		parallel_merge_detail::parallel_for(tc::size(vecpairn) - 1, [&](std::size_t i) noexcept {
+			auto const itA = tc::begin(rngA);
+			auto const itB = tc::begin(rngB);
+			// std::merge takes from the first range on ties, like tc::merge_range.
+			std::merge(
+				itA + vecpairn[i].first, itA + vecpairn[i + 1].first,
+				itB + vecpairn[i].second, itB + vecpairn[i + 1].second,
+				itOut + (vecpairn[i].first + vecpairn[i].second),
+				less
+			);
+		});
+		return itOut + (tc::size(rngA) + tc::size(rngB));
+	}
+
+	// Like tc::make_vector(tc::intersect(rngA, rngB, comp)), using nPartitions threads.
+	template<typename RngA, typename RngB, typename Comp = tc::fn_compare>
+	auto parallel_intersect(RngA const& rngA, RngB const& rngB, Comp const& comp = Comp(), std::size_t const nPartitions = 0) noexcept {
+		return parallel_merge_detail::parallel_set_operation(rngA, rngB, comp, nPartitions, [](auto&& rngSubA, auto&& rngSubB, Comp const& comp) noexcept {
+			return tc::intersect(tc_move_if_owned(rngSubA), tc_move_if_owned(rngSubB), comp);
+		});
+	}
+
+	// Like tc::make_vector(tc::difference(rngA, rngB, comp)), using nPartitions threads.
+	template<typename RngA, typename RngB, typename Comp = tc::fn_compare>
+	auto parallel_difference(RngA const& rngA, RngB const& rngB, Comp const& comp = Comp(), std::size_t const nPartitions = 0) noexcept {
+		return parallel_merge_detail::parallel_set_operation(rngA, rngB, comp, nPartitions, [](auto&& rngSubA, auto&& rngSubB, Comp const& comp) noexcept {
+			return tc::difference(tc_move_if_owned(rngSubA), tc_move_if_owned(rngSubB), comp);
+		});
+	}
+
+	// Like tc::make_vector(tc::union_range(rngA, rngB, comp)), using nPartitions threads.
+	template<typename RngA, typename RngB, typename Comp = tc::fn_compare>
+	auto parallel_union(RngA const& rngA, RngB const& rngB, Comp const& comp = Comp(), std::size_t const nPartitions = 0) noexcept {
+		return parallel_merge_detail::parallel_set_operation(rngA, rngB, comp, nPartitions, [](auto&& rngSubA, auto&& rngSubB, Comp const& comp) noexcept {
+			return tc::union_range(tc_move_if_owned(rngSubA), tc_move_if_owned(rngSubB), comp);
+		});
+	}
+}
@@ -0,0 +1,61 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../range/merge_range.h"
+#include "parallel_merge.h"
+
+namespace {
+	struct key_payload final {
+		int m_nKey;
+		int m_nPayload;
+		friend bool operator==(key_payload const&, key_payload const&) noexcept = default;
+	};
+}
+
+UNITTESTDEF(parallel_merge_stable) {
+	// Many duplicates across inputs, so split points fall into runs of equal keys.
+	tc::vector<key_payload> vecA, vecB;
+	for( int i = 0; i < 1000; ++i ) tc::cont_emplace_back(vecA, key_payload{i / 7, i});
+	for( int i = 0; i < 600; ++i ) tc::cont_emplace_back(vecB, key_payload{i / 3, -i});
+	auto const less = [](key_payload const& lhs, key_payload const& rhs) noexcept { return lhs.m_nKey < rhs.m_nKey; };
+	tc::vector<key_payload> vecExpected;
+	tc::for_each(tc::merge_range(vecA, vecB, less), [&](key_payload const& kp) noexcept { tc::cont_emplace_back(vecExpected, kp); });
+	for( std::size_t nPartitions = 1; nPartitions < 9; ++nPartitions ) {
+		tc::vector<key_payload> vecOut(tc::size(vecA) + tc::size(vecB));
+		_ASSERT( tc::end(vecOut) == tc::parallel_merge(vecA, vecB, tc::begin(vecOut), less, nPartitions) );
+		_ASSERT( vecExpected == vecOut );
+	}
+
+	// All keys equal: the parts of a merge stay balanced, and the merge is still stable.
+	tc::vector<key_payload> vecAEqual, vecBEqual;
+	for( int i = 0; i < 1000; ++i ) tc::cont_emplace_back(vecAEqual, key_payload{0, i});
+	for( int i = 0; i < 600; ++i ) tc::cont_emplace_back(vecBEqual, key_payload{0, -i});
+	auto const vecpairn = tc::parallel_merge_detail::merge_path_partition</*bGroupEqual*/false>(vecAEqual, vecBEqual, less, 4);
+	for( std::size_t i = 0; i < 4; ++i ) {
+		_ASSERTEQUAL( vecpairn[i + 1].first + vecpairn[i + 1].second - vecpairn[i].first - vecpairn[i].second, 400 );
+	}
+	tc::vector<key_payload> vecOutEqual(1600);
+	tc::parallel_merge(vecAEqual, vecBEqual, tc::begin(vecOutEqual), less, 4);
+	_ASSERT( tc::equal(tc::make_iterator_range(tc::begin(vecOutEqual), tc::begin(vecOutEqual) + 1000), vecAEqual) );
+	_ASSERT( tc::equal(tc::make_iterator_range(tc::begin(vecOutEqual) + 1000, tc::end(vecOutEqual)), vecBEqual) );
+}
+
+UNITTESTDEF(parallel_set_operations) {
+	tc::vector<int> vecA, vecB;
+	for( int i = 0; i < 3000; ++i ) tc::cont_emplace_back(vecA, i / 4);
+	for( int i = 0; i < 2000; ++i ) tc::cont_emplace_back(vecB, 3 * (i / 5));
+	for( std::size_t nPartitions = 1; nPartitions < 9; ++nPartitions ) {
+		_ASSERT( tc::equal(tc::parallel_intersect(vecA, vecB, tc::fn_compare(), nPartitions), tc::intersect(vecA, vecB)) );
+		_ASSERT( tc::equal(tc::parallel_difference(vecA, vecB, tc::fn_compare(), nPartitions), tc::difference(vecA, vecB)) );
+		_ASSERT( tc::equal(tc::parallel_union(vecA, vecB, tc::fn_compare(), nPartitions), tc::union_range(vecA, vecB)) );
+	}
+	_ASSERT( tc::empty(tc::parallel_intersect(tc::vector<int>{}, vecB)) );
+	_ASSERT( tc::equal(tc::parallel_union(tc::vector<int>{}, vecB), vecB) );
+}
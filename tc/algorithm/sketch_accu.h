@@ -0,0 +1,307 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/type_traits_fwd.h"
+#include "../container/container.h"
+#include "../container/cont_reserve.h"
+#include "algorithm.h"
+#include "accumulate.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numbers>
+#include <string_view>
+
+namespace tc {
+	namespace sketch_detail {
+		// Hashes with std::hash, contiguous character ranges via std::basic_string_view.
+		struct fn_hash final {
+			template<typename T>
+			std::size_t operator()(T const& t) const& noexcept {
+				if constexpr( requires { std::hash<T>()(t); } ) {
+					return std::hash<T>()(t);
+				} else {
+					using char_t = std::remove_cv_t<std::remove_pointer_t<decltype(tc::ptr_begin(t))>>;
+					static_assert( tc::char_type<char_t> );
+					return std::hash<std::basic_string_view<char_t>>()(std::basic_string_view<char_t>(tc::ptr_begin(t), tc::size(t)));
+				}
+			}
+		};
+
+		// std::hash is the identity for integers on common implementations. Sketches need all 64 bits well mixed (splitmix64 finalizer).
+		constexpr std::uint64_t mix(std::uint64_t n) noexcept {
+			n ^= n >> 30;
+			n *= 0xbf58476d1ce4e5b9;
+			n ^= n >> 27;
+			n *= 0x94d049bb133111eb;
+			n ^= n >> 31;
+			return n;
+		}
+	}
+
+	// Approximate accumulators with memory bounded independently of the input size. They are stateful sinks,
+	// so pass them to tc::for_each via std::ref, like other stateful functors, or accumulate into them with tc::fn_sketch_add.
+	namespace no_adl {
+		// HyperLogLog (Flajolet et al.) sink estimating the number of distinct values passed to it, using 2^nPrecision one-byte registers.
+		// The standard error is about 1.04 / sqrt(2^nPrecision), e.g., 0.8% for the default precision 14, which takes 16 KB.
+		// Sketches with the same precision and hash can be merged, e.g., to combine per-thread sketches.
+		template<typename Hash = sketch_detail::fn_hash>
+		struct [[nodiscard]] hyperloglog_accu final {
+			explicit hyperloglog_accu(int nPrecision = 14, Hash hash = Hash()) noexcept
+				: m_vecnRegister(std::size_t(1) << nPrecision, 0)
+				, m_nPrecision(nPrecision)
+				, m_hash(tc_move(hash))
+			{
+				_ASSERT( 4 <= nPrecision && nPrecision <= 18 );
+			}
+
+			template<typename T>
+			void operator()(T const& t) & noexcept {
+				auto const n = sketch_detail::mix(tc::invoke(m_hash, t));
+				auto const nRegister = tc::explicit_cast<std::size_t>(n >> (64 - m_nPrecision));
+				// Position of the first 1 bit in the remaining bits. The bit below them ensures that it is at most 64 - m_nPrecision + 1.
+				auto const nRank = tc::explicit_cast<std::uint8_t>(std::countl_zero((n << m_nPrecision) | (std::uint64_t(1) << (m_nPrecision - 1))) + 1);
+				tc::assign_max(m_vecnRegister[nRegister], nRank);
+			}
+
+			void merge(hyperloglog_accu const& other) & noexcept {
+				_ASSERTEQUAL( m_nPrecision, other.m_nPrecision );
+				for( std::size_t i = 0; i < tc::size(m_vecnRegister); ++i ) { // vectorizes to byte-wise max
+					m_vecnRegister[i] = tc::max(m_vecnRegister[i], other.m_vecnRegister[i]);
+				}
+			}
+
+			// Estimated number of distinct values, with linear counting for small cardinalities.
+			[[nodiscard]] double estimate() const& noexcept {
+				auto const m = tc::explicit_cast<double>(tc::size(m_vecnRegister));
+				double dSum = 0;
+				std::size_t nZeros = 0;
+				for( auto const nRank : m_vecnRegister ) {
+					dSum += std::ldexp(1.0, -nRank);
+					if( 0 == nRank ) ++nZeros;
+				}
+				double const dAlpha = [&]() noexcept {
+					switch( m_nPrecision ) {
+						case 4: return 0.673;
+						case 5: return 0.697;
+						case 6: return 0.709;
+						default: return 0.7213 / (1 + 1.079 / m);
+					}
+				}();
+				auto const dEstimate = dAlpha * m * m / dSum;
+				if( dEstimate <= 2.5 * m && 0 < nZeros ) {
+					return m * std::log(m / tc::explicit_cast<double>(nZeros));
+				} else {
+					return dEstimate;
+				}
+			}
+
+			void clear() & noexcept {
+				std::fill(tc::begin(m_vecnRegister), tc::end(m_vecnRegister), std::uint8_t(0));
+			}
+
+		private:
+			tc::vector<std::uint8_t> m_vecnRegister;
+			int m_nPrecision;
+			[[no_unique_address]] Hash m_hash;
+		};
+
+		// Count-min sketch (Cormode and Muthukrishnan) sink counting how often values were passed to it, in nDepth rows of nWidth counters.
+		// count(t) never underestimates, and overestimates by at most e / nWidth * total() with probability 1 - e^-nDepth.
+		// Useful for finding heavy hitters: values with count(t) above a fraction of total().
+		// Sketches with the same dimensions and hash can be merged.
+		template<typename Hash = sketch_detail::fn_hash>
+		struct [[nodiscard]] count_min_accu final {
+			explicit count_min_accu(std::size_t nWidth, std::size_t nDepth, Hash hash = Hash()) noexcept
+				: m_vecnCounter(nWidth * nDepth, 0)
+				, m_nWidth(nWidth)
+				, m_nDepth(nDepth)
+				, m_hash(tc_move(hash))
+			{
+				_ASSERT( 0 < nWidth && nWidth <= std::numeric_limits<std::uint32_t>::max() && 0 < nDepth );
+			}
+
+			template<typename T>
+			void operator()(T const& t) & noexcept {
+				add(t, 1);
+			}
+
+			template<typename T>
+			void add(T const& t, std::uint64_t n) & noexcept {
+				for_each_counter(*this, t, [&](std::uint64_t& nCounter) noexcept { nCounter += n; });
+				m_nTotal += n;
+			}
+
+			template<typename T>
+			[[nodiscard]] std::uint64_t count(T const& t) const& noexcept {
+				auto nCount = std::numeric_limits<std::uint64_t>::max();
+				for_each_counter(*this, t, [&](std::uint64_t const nCounter) noexcept { tc::assign_min(nCount, nCounter); });
+				return nCount;
+			}
+
+			std::uint64_t total() const& noexcept {
+				return m_nTotal;
+			}
+
+			void merge(count_min_accu const& other) & noexcept {
+				_ASSERTEQUAL( m_nWidth, other.m_nWidth );
+				_ASSERTEQUAL( m_nDepth, other.m_nDepth );
+				for( std::size_t i = 0; i < tc::size(m_vecnCounter); ++i ) {
+					m_vecnCounter[i] += other.m_vecnCounter[i];
+				}
+				m_nTotal += other.m_nTotal;
+			}
+
+		private:
+			// Row i uses the hash h1 + i * h2 (Kirsch and Mitzenmacher), mapped to [0, m_nWidth) by multiply-shift instead of modulo.
+			template<typename Self, typename T, typename Func>
+			static void for_each_counter(Self& self, T const& t, Func func) noexcept {
+				auto const n = sketch_detail::mix(tc::invoke(self.m_hash, t));
+				auto const n1 = static_cast<std::uint32_t>(n);
+				auto const n2 = static_cast<std::uint32_t>(n >> 32) | 1;
+				for( std::size_t i = 0; i < self.m_nDepth; ++i ) {
+					auto const nHash = static_cast<std::uint32_t>(n1 + i * n2);
+					func(self.m_vecnCounter[i * self.m_nWidth + tc::explicit_cast<std::size_t>((std::uint64_t(nHash) * self.m_nWidth) >> 32)]);
+				}
+			}
+
+			tc::vector<std::uint64_t> m_vecnCounter; // row-major
+			std::size_t m_nWidth;
+			std::size_t m_nDepth;
+			std::uint64_t m_nTotal = 0;
+			[[no_unique_address]] Hash m_hash;
+		};
+
+		// Merging t-digest (Dunning) sink estimating quantiles of the numbers passed to it. Holds at most about dCompression centroids
+		// plus a buffer of 4 * dCompression values. Quantiles near 0 and 1 are most accurate, because centroids there are smallest.
+		// Digests can be merged.
+		struct [[nodiscard]] tdigest_accu final {
+			explicit tdigest_accu(double dCompression = 100) noexcept
+				: m_dCompression(dCompression)
+				, m_nBufferSize(tc::explicit_cast<std::size_t>(4 * dCompression))
+			{
+				_ASSERT( 10 <= dCompression );
+				tc::cont_reserve(m_veccentroid, m_nBufferSize + tc::explicit_cast<std::size_t>(dCompression) + 1);
+			}
+
+			void operator()(double d) & noexcept {
+				add(d, 1);
+			}
+
+			void add(double d, double dWeight) & noexcept {
+				_ASSERT( !std::isnan(d) && 0 < dWeight );
+				tc::cont_emplace_back(m_veccentroid, centroid{d, dWeight});
+				m_dWeight += dWeight;
+				tc::assign_min(m_dMin, d);
+				tc::assign_max(m_dMax, d);
+				if( m_nBufferSize <= tc::size(m_veccentroid) - m_nCompressed ) compress();
+			}
+
+			void merge(tdigest_accu const& other) & noexcept {
+				tc::append(m_veccentroid, other.m_veccentroid);
+				m_dWeight += other.m_dWeight;
+				tc::assign_min(m_dMin, other.m_dMin);
+				tc::assign_max(m_dMax, other.m_dMax);
+				compress();
+			}
+
+			// Estimated value below which the fraction dQuantile of the weight lies. NaN if nothing was added.
+			[[nodiscard]] double quantile(double dQuantile) & noexcept {
+				_ASSERT( 0 <= dQuantile && dQuantile <= 1 );
+				if( tc::empty(m_veccentroid) ) return std::numeric_limits<double>::quiet_NaN();
+				compress();
+				auto const dTarget = dQuantile * m_dWeight;
+				// Each centroid represents its weight spread around its mean; interpolate between the centers of adjacent centroids.
+				double dCenterPrev = 0;
+				double dMeanPrev = m_dMin;
+				double dWeightSoFar = 0;
+				for( auto const& c : m_veccentroid ) {
+					auto const dCenter = dWeightSoFar + c.m_dWeight / 2;
+					if( dTarget < dCenter ) {
+						return dMeanPrev + (c.m_dMean - dMeanPrev) * (dTarget - dCenterPrev) / (dCenter - dCenterPrev);
+					}
+					dCenterPrev = dCenter;
+					dMeanPrev = c.m_dMean;
+					dWeightSoFar += c.m_dWeight;
+				}
+				if( m_dWeight <= dCenterPrev ) return m_dMax;
+				return dMeanPrev + (m_dMax - dMeanPrev) * (dTarget - dCenterPrev) / (m_dWeight - dCenterPrev);
+			}
+
+			double total_weight() const& noexcept {
+				return m_dWeight;
+			}
+
+			std::size_t centroid_count() & noexcept {
+				compress();
+				return tc::size(m_veccentroid);
+			}
+
+		private:
+			struct centroid final {
+				double m_dMean;
+				double m_dWeight;
+			};
+
+			// Scale function k1: centroids may span one unit of k, which makes them small near the tails.
+			double k(double dQuantile) const& noexcept {
+				return m_dCompression / (2 * std::numbers::pi) * std::asin(2 * dQuantile - 1);
+			}
+			double k_inverse(double dK) const& noexcept {
+				return (std::sin(dK * 2 * std::numbers::pi / m_dCompression) + 1) / 2;
+			}
+
+			void compress() & noexcept {
+				if( tc::size(m_veccentroid) == m_nCompressed ) return;
+				tc::sort_inplace(m_veccentroid, tc::projected(tc::fn_less(), tc_member(.m_dMean)));
+				std::size_t nOut = 0;
+				double dWeightSoFar = 0;
+				double dQuantileLimit = k_inverse(k(0) + 1) * m_dWeight;
+				for( std::size_t i = 1; i < tc::size(m_veccentroid); ++i ) {
+					auto& cOut = m_veccentroid[nOut];
+					auto const& c = m_veccentroid[i];
+					if( dWeightSoFar + cOut.m_dWeight + c.m_dWeight <= dQuantileLimit ) {
+						cOut.m_dWeight += c.m_dWeight;
+						cOut.m_dMean += (c.m_dMean - cOut.m_dMean) * c.m_dWeight / cOut.m_dWeight;
+					} else {
+						dWeightSoFar += cOut.m_dWeight;
+						dQuantileLimit = k_inverse(k(dWeightSoFar / m_dWeight) + 1) * m_dWeight;
+						m_veccentroid[++nOut] = c;
+					}
+				}
+				tc::take_first_inplace(m_veccentroid, nOut + 1);
+				m_nCompressed = tc::size(m_veccentroid);
+			}
+
+			tc::vector<centroid> m_veccentroid; // [0, m_nCompressed) are compressed and sorted, the rest is the buffer
+			std::size_t m_nCompressed = 0;
+			double m_dCompression;
+			std::size_t m_nBufferSize;
+			double m_dWeight = 0;
+			double m_dMin = std::numeric_limits<double>::infinity();
+			double m_dMax = -std::numeric_limits<double>::infinity();
+		};
+	}
+	using no_adl::hyperloglog_accu;
+	using no_adl::count_min_accu;
+	using no_adl::tdigest_accu;
+
+	// Accumulation operation for the sketches above, e.g., tc::accumulate(rng, tc::hyperloglog_accu<>(), tc::fn_sketch_add()).
+	template<typename Accu, typename T>
+	void sketch_add(Accu& accu, T const& t) noexcept {
+		accu(t);
+	}
+
+	tc_define_fn( sketch_add );
+}
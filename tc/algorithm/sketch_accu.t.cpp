@@ -0,0 +1,99 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../range/iota_range.h"
+#include "../range/transform_adaptor.h"
+#include "../string/format.h"
+#include "sketch_accu.h"
+
+#include <cmath>
+#include <functional>
+
+UNITTESTDEF(hyperloglog_accu) {
+	tc::hyperloglog_accu<> hll;
+	_ASSERTEQUAL( hll.estimate(), 0 );
+	// Each value three times.
+	tc::for_each(tc::transform(tc::iota(0, 300000), [](int n) noexcept { return n % 100000; }), std::ref(hll));
+	_ASSERT( std::abs(hll.estimate() - 100000) < 3000 );
+
+	tc::hyperloglog_accu<> hllSmall;
+	tc::for_each(tc::iota(0, 100), std::ref(hllSmall));
+	_ASSERT( std::abs(hllSmall.estimate() - 100) < 3 ); // linear counting
+
+	// Merging per-thread sketches of overlapping sets.
+	tc::hyperloglog_accu<> hll1;
+	tc::hyperloglog_accu<> hll2;
+	tc::for_each(tc::iota(0, 60000), std::ref(hll1));
+	tc::for_each(tc::iota(40000, 100000), std::ref(hll2));
+	hll1.merge(hll2);
+	_ASSERT( std::abs(hll1.estimate() - 100000) < 3000 );
+
+	tc::hyperloglog_accu<> hllStr;
+	for( int i = 0; i < 1000; ++i ) {
+		hllStr(tc::make_str<char>("key", tc::as_dec(i % 500)));
+	}
+	_ASSERT( std::abs(hllStr.estimate() - 500) < 25 );
+}
+
+UNITTESTDEF(count_min_accu) {
+	tc::count_min_accu<> cms(1000, 4);
+	// Value 7 is a heavy hitter, the others appear once or twice.
+	for( int i = 0; i < 20000; ++i ) {
+		cms(i % 10 == 0 ? 7 : i % 9000 + 100);
+	}
+	_ASSERTEQUAL( cms.total(), 20000 );
+	_ASSERT( 2000 <= cms.count(7) && cms.count(7) <= 2000 + 20000 * 3 / 1000 );
+	_ASSERT( 2 <= cms.count(200) );
+	_ASSERT( cms.count(200) < 2000 / 10 );
+
+	tc::count_min_accu<> cms2(1000, 4);
+	cms2.add(7, 500);
+	cms.merge(cms2);
+	_ASSERT( 2500 <= cms.count(7) );
+	_ASSERTEQUAL( cms.total(), 20500 );
+}
+
+UNITTESTDEF(tdigest_accu) {
+	tc::tdigest_accu td;
+	_ASSERT( std::isnan(td.quantile(0.5)) );
+	for( int i = 0; i < 100000; ++i ) {
+		td((i * 7919) % 100000); // all values in [0, 100000), shuffled
+	}
+	_ASSERTEQUAL( td.total_weight(), 100000 );
+	_ASSERT( td.centroid_count() <= 100 );
+	_ASSERT( std::abs(td.quantile(0.5) - 50000) < 1000 );
+	_ASSERT( std::abs(td.quantile(0.99) - 99000) < 200 );
+	_ASSERT( std::abs(td.quantile(0.001) - 100) < 50 );
+	_ASSERTEQUAL( td.quantile(0), 0 );
+	_ASSERTEQUAL( td.quantile(1), 99999 );
+
+	tc::tdigest_accu td1;
+	tc::tdigest_accu td2;
+	tc::for_each(tc::iota(0, 50000), std::ref(td1));
+	tc::for_each(tc::iota(50000, 100000), std::ref(td2));
+	td1.merge(td2);
+	_ASSERT( std::abs(td1.quantile(0.25) - 25000) < 1000 );
+	_ASSERT( std::abs(td1.quantile(0.75) - 75000) < 1000 );
+}
+
+UNITTESTDEF(sketch_accu_accumulate) {
+	auto const hll = tc::accumulate(tc::iota(0, 1000), tc::hyperloglog_accu<>(), tc::fn_sketch_add());
+	_ASSERT( std::abs(hll.estimate() - 1000) < 30 );
+
+	auto const cms = tc::accumulate(tc::iota(0, 1000), tc::count_min_accu<>(100, 4), [](auto& cms_, int n) noexcept {
+		tc::sketch_add(cms_, n % 10);
+	});
+	_ASSERTEQUAL( cms.total(), 1000 );
+	_ASSERT( 100 <= cms.count(3) );
+
+	auto td = tc::accumulate(tc::iota(0, 1001), tc::tdigest_accu(), tc::fn_sketch_add());
+	_ASSERTEQUAL( td.total_weight(), 1001 );
+	_ASSERT( std::abs(td.quantile(0.5) - 500) < 10 );
+}
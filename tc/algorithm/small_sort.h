@@ -0,0 +1,115 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/utility.h"
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace tc {
+	namespace small_sort_detail {
+		// Ranges of statically known size up to this size are sorted by a sorting network, see c_bSortingNetwork.
+		inline constexpr std::size_t c_nMaxSortingNetworkSize = 32;
+		// Other ranges up to this size are sorted by insertion sort.
+		inline constexpr std::size_t c_nMaxInsertionSortSize = 16;
+
+		// Small trivially copyable elements are compare-exchanged with conditional moves, so the sort does not mispredict branches.
+		template<typename T>
+		inline constexpr bool c_bBranchless = std::is_trivially_copyable<T>::value && sizeof(T) <= 2 * sizeof(void*);
+
+		// Sorting networks only pay off with branchless compare-exchanges. Otherwise, each of their many comparators is a branch
+		// and a swap, while insertion sort moves every element only once.
+		template<typename T, std::size_t N>
+		inline constexpr bool c_bSortingNetwork = c_bBranchless<T> && N <= c_nMaxSortingNetworkSize;
+
+		template<typename T, typename Less>
+		constexpr void compare_exchange(T& lhs, T& rhs, Less& less) noexcept {
+			if constexpr( c_bBranchless<T> ) {
+				T const tLhs = lhs;
+				T const tRhs = rhs;
+				bool const bSwap = less(tRhs, tLhs);
+				lhs = bSwap ? tRhs : tLhs;
+				rhs = bSwap ? tLhs : tRhs;
+			} else if( less(rhs, lhs) ) {
+				tc::swap(lhs, rhs);
+			}
+		}
+
+		// Batcher's odd-even merge sort network for the next power of two, without the comparators touching indices >= n,
+		// i.e., the missing elements behave like +infinity. This is size-optimal for n <= 8 and close to the best known networks up to 32.
+		template<typename Func>
+		constexpr void for_each_comparator(std::size_t const n, Func func) noexcept {
+			std::size_t nPow2 = 1;
+			while( nPow2 < n ) nPow2 *= 2;
+			for( std::size_t p = 1; p < nPow2; p *= 2 ) {
+				for( std::size_t k = p; 1 <= k; k /= 2 ) {
+					for( std::size_t j = k % p; j + k < n; j += 2 * k ) {
+						for( std::size_t i = 0; i < k && i + j + k < n; ++i ) {
+							if( (i + j) / (2 * p) == (i + j + k) / (2 * p) ) {
+								func(i + j, i + j + k);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		template<std::size_t N>
+		inline constexpr std::size_t c_nComparators = []() noexcept {
+			std::size_t nComparators = 0;
+			for_each_comparator(N, [&](std::size_t, std::size_t) noexcept { ++nComparators; });
+			return nComparators;
+		}();
+
+		template<std::size_t N>
+		inline constexpr auto c_apairnNetwork = []() noexcept {
+			std::array<std::pair<std::size_t, std::size_t>, c_nComparators<N>> apairn{};
+			std::size_t i = 0;
+			for_each_comparator(N, [&](std::size_t nLhs, std::size_t nRhs) noexcept {
+				apairn[i] = {nLhs, nRhs};
+				++i;
+			});
+			return apairn;
+		}();
+
+		// Fully unrolled sorting network for N elements starting at it.
+		template<std::size_t N, typename It, typename Less>
+		constexpr void sorting_network(It const it, Less& less) noexcept {
+			[&]<std::size_t... I>(std::index_sequence<I...>) noexcept {
+				(small_sort_detail::compare_exchange(it[c_apairnNetwork<N>[I].first], it[c_apairnNetwork<N>[I].second], less), ...);
+			}(std::make_index_sequence<c_nComparators<N>>());
+		}
+
+		template<typename It, typename Less>
+		constexpr void insertion_sort(It const itBegin, It const itEnd, Less& less) noexcept {
+			using value_t = std::remove_reference_t<decltype(*itBegin)>;
+			if constexpr( c_bBranchless<value_t> ) {
+				// Each new element sinks through all its predecessors by compare-exchange. This costs O(n^2) comparisons, but
+				// for the sizes we use it for, the missing mispredicted branch at the insertion point is the better deal.
+				for( auto it = itBegin; it != itEnd; ++it ) {
+					for( auto itSink = it; itSink != itBegin; --itSink ) {
+						small_sort_detail::compare_exchange(*(itSink - 1), *itSink, less);
+					}
+				}
+			} else if( itBegin != itEnd ) {
+				for( auto it = itBegin + 1; it != itEnd; ++it ) {
+					value_t t = tc_move_always(*it);
+					auto itHole = it;
+					for( ; itHole != itBegin && less(t, *(itHole - 1)); --itHole ) {
+						*itHole = tc_move_always(*(itHole - 1));
+					}
+					*itHole = tc_move(t);
+				}
+			}
+		}
+	}
+}
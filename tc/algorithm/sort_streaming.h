@@ -8,12 +8,16 @@
 
 #pragma once
 
+#include "algorithm.h"
 #include "append.h"
 #include "element.h"
 #include "../range/reverse_adaptor.h"
 
 #include <boost/range/algorithm/heap_algorithm.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace tc {
 	template<typename Cont, typename T, typename Less = tc::fn_less>
 	void replace_heap(Cont& cont, T&& t, Less less = Less()) noexcept {
@@ -78,4 +82,100 @@ namespace tc {
 			return tc::constant<tc::continue_>();
 		});
 	}
+
+	namespace sort_streaming_detail {
+		template<typename Rng>
+		std::size_t bounded_reserve(Rng const& rng, std::size_t const n) noexcept {
+			if constexpr( tc::has_size<Rng const&> ) {
+				return tc::min(tc::implicit_cast<std::size_t>(tc::size(rng)), n);
+			} else {
+				return 0;
+			}
+		}
+	}
+
+	template<typename Rng, typename Less = tc::fn_less>
+	auto sort_streaming_bounded(Rng&& rng, std::size_t const n, Less&& less = Less()) noexcept {
+		// Like tc::take_first(tc::sort_streaming(rng, less), n), but holds at most n elements instead of a copy of rng.
+		// Keeps the n smallest elements seen so far in a max-heap, so each further element costs one comparison with the heap top
+		// and O(log n) if it is smaller. Works for single-pass generator ranges.
+		// Notes:
+		//  * not a stable sort algorithm, which of several elements equal to the n-th one are kept is unspecified
+		//  * first element is generated in O(size(rng) * log(n))
+		return tc::generator_range_output<tc::range_value_t<Rng const&>&>([
+			rng = tc::make_reference_or_value(std::forward<Rng>(rng)),
+			n,
+			less = tc::decay_copy(std::forward<Less>(less))
+		](auto&& sink) MAYTHROW -> tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<tc::range_value_t<Rng const&>&>())), tc::constant<tc::continue_>> {
+			using value_t = tc::range_value_t<Rng const&>;
+			tc::vector<value_t> vec;
+			if( 0 < n ) {
+				tc::cont_reserve(vec, sort_streaming_detail::bounded_reserve(*rng, n));
+				tc::for_each(*rng, [&](auto&& t) noexcept {
+					if( tc::size(vec) < n ) {
+						tc::cont_emplace_back(vec, tc_move_if_owned(t));
+						if( tc::size(vec) == n ) boost::range::make_heap(vec, std::ref(less));
+					} else if( less(tc::as_const(t), tc::as_const(tc::front(vec))) ) {
+						tc::replace_heap(vec, value_t(tc_move_if_owned(t)), std::ref(less));
+					}
+				});
+				if( tc::size(vec) == n ) {
+					boost::range::sort_heap(vec, std::ref(less));
+				} else {
+					tc::sort_inplace(vec, std::ref(less));
+				}
+			}
+			for( auto& t : vec ) {
+				tc_yield(sink, t); // MAYTHROW
+			}
+			return tc::constant<tc::continue_>();
+		});
+	}
+
+	template<typename Rng, typename Less = tc::fn_less>
+	auto top_k(Rng&& rng, std::size_t const n, Less&& less = Less()) noexcept {
+		// Generates the n smallest elements of rng with respect to less, in ascending order. Holds O(n) elements, not a copy of rng.
+		// Random-access ranges with known size are filtered in batches: the buffer of 2n elements is cut back to its n smallest by quickselect
+		// (std::nth_element) whenever it is full, and afterwards elements not smaller than the current n-th are skipped with one comparison.
+		// This takes O(size(rng) + n * log(n)) expected time. Other ranges use the bounded heap of tc::sort_streaming_bounded.
+		// Notes:
+		//  * not a stable sort algorithm, which of several elements equal to the n-th one are generated is unspecified
+		if constexpr( tc::random_access_range<std::remove_reference_t<Rng> const> && tc::has_size<std::remove_reference_t<Rng> const> ) {
+			return tc::generator_range_output<tc::range_value_t<Rng const&>&>([
+				rng = tc::make_reference_or_value(std::forward<Rng>(rng)),
+				n,
+				less = tc::decay_copy(std::forward<Less>(less))
+			](auto&& sink) MAYTHROW -> tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<tc::range_value_t<Rng const&>&>())), tc::constant<tc::continue_>> {
+				tc::vector<tc::range_value_t<Rng const&>> vec;
+				if( 0 < n ) {
+					// Not 2 * n, which may overflow. If rng has fewer elements, the buffer is never full.
+					auto const nBuffer = tc::min(tc::implicit_cast<std::size_t>(tc::size(*rng)), tc::min(n, std::numeric_limits<std::size_t>::max() / 2) * 2);
+					tc::cont_reserve(vec, nBuffer); // never reallocates, so the n-th element stays in place until the next cut
+					auto const select = [&]() noexcept {
+						std::nth_element(tc::begin(vec), tc::begin(vec) + (n - 1), tc::end(vec), std::ref(less));
+						tc::take_first_inplace(vec, n);
+					};
+					bool bCut = false;
+					tc::for_each(*rng, [&](auto const& t) noexcept {
+						if( !bCut || less(t, tc::as_const(vec[n - 1])) ) {
+							if( tc::size(vec) == nBuffer ) {
+								select();
+								bCut = true;
+								if( !less(t, tc::as_const(vec[n - 1])) ) return;
+							}
+							tc::cont_emplace_back(vec, t);
+						}
+					});
+					if( n < tc::size(vec) ) select();
+					tc::sort_inplace(vec, std::ref(less));
+				}
+				for( auto& t : vec ) {
+					tc_yield(sink, t); // MAYTHROW
+				}
+				return tc::constant<tc::continue_>();
+			});
+		} else {
+			return tc::sort_streaming_bounded(std::forward<Rng>(rng), n, std::forward<Less>(less));
+		}
+	}
 }
@@ -22,3 +22,29 @@ UNITTESTDEF( sort_streaming ) {
 		"9876543221100"
 	);
 }
+
+UNITTESTDEF( top_k ) {
+	_ASSERTEQUAL( tc::make_str(tc::top_k("5714926380", 3)), "012" );
+	_ASSERTEQUAL( tc::make_str(tc::top_k("5714926380", 3, tc::fn_greater())), "987" );
+	_ASSERTEQUAL( tc::make_str(tc::top_k("5714926380", 20)), "0123456789" );
+	_ASSERT( tc::empty(tc::make_str(tc::top_k("5714926380", 0))) );
+	_ASSERTEQUAL( tc::make_str(tc::top_k("5714926380", std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1))), "0123456789" ); // 2 * n overflows
+	_ASSERTEQUAL( tc::make_str(tc::sort_streaming_bounded("5714926380", 4)), "0123" );
+	_ASSERTEQUAL( tc::make_str(tc::sort_streaming_bounded("5714926380", 10)), "0123456789" );
+	_ASSERTEQUAL( tc::make_str(tc::sort_streaming_bounded("5714926380", 20)), "0123456789" );
+
+	// Single-pass generator input.
+	auto const rngn = tc::transform(tc::iota(0, 1000), [](int n) noexcept { return (n * 7919) % 1000; });
+	auto const vecnExpected = tc::make_vector(tc::iota(0, 10));
+	_ASSERT( tc::equal(tc::sort_streaming_bounded(tc::generator_range_output<int>([&](auto&& sink) noexcept { return tc::for_each(rngn, sink); }), 10), vecnExpected) );
+
+	// Random-access input, with several cuts of the buffer and duplicates.
+	auto const vecn = tc::make_vector(tc::transform(tc::iota(0, 1000), [](int n) noexcept { return (n * 7919) % 500; }));
+	for( std::size_t n = 1; n < 40; ++n ) {
+		auto vecnSorted = vecn;
+		tc::sort_inplace(vecnSorted);
+		tc::take_first_inplace(vecnSorted, n);
+		_ASSERT( tc::equal(tc::top_k(vecn, n), vecnSorted) );
+		_ASSERT( tc::equal(tc::sort_streaming_bounded(vecn, n), vecnSorted) );
+	}
+}
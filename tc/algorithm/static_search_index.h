@@ -0,0 +1,163 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/reference_or_value.h"
+#include "../container/container.h"
+#include "../range/subrange.h"
+#include "algorithm.h"
+
+#include <bit>
+#include <cstdint>
+
+namespace tc {
+	namespace static_search_index_detail {
+		inline void prefetch(void const* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(p);
+#else
+			tc::discard(p);
+#endif
+		}
+	}
+
+	namespace static_search_index_adl {
+		// Read-only search index over a sorted random-access range, for many lookups into the same large range.
+		// The keys are copied into Eytzinger order, i.e., the implicit binary tree with the children of node k at 2k and 2k+1.
+		// The top levels of the tree share few cache lines, and the descent prefetches the cache line holding the
+		// 16 descendants four levels down, so a lookup waits for memory about once every four levels instead of once per level.
+		// The descent has no data-dependent branches.
+		// Results refer to the original range and follow the RangeReturn conventions of tc::lower_bound and tc::binary_find_unique.
+		template<typename Rng, typename Less = tc::fn_less>
+		struct [[nodiscard]] static_search_index final {
+		private:
+			using key_type = tc::range_value_t<Rng>;
+
+			tc::reference_or_value<Rng> m_rng;
+			tc::vector<key_type> m_veckey; // m_veckey[k] for 1 <= k <= n is node k, m_veckey[0] is unused
+			tc::vector<std::size_t> m_vecnIndex; // m_vecnIndex[k] is the index in m_rng of node k, m_vecnIndex[0] is the size of m_rng
+			Less m_less;
+
+			// In-order traversal assigns the sorted keys to the nodes.
+			template<typename It>
+			void build(std::size_t k, It& it, std::size_t& nIndex) & noexcept {
+				if( k < tc::size(m_veckey) ) {
+					build(2 * k, it, nIndex);
+					m_veckey[k] = *it;
+					m_vecnIndex[k] = nIndex;
+					++it;
+					++nIndex;
+					build(2 * k + 1, it, nIndex);
+				}
+			}
+
+			// Descends taking the right child while pred(key) holds. Returns the node of the first key for which pred fails, or 0.
+			template<typename Pred>
+			std::size_t descend(Pred pred) const& noexcept {
+				auto const n = tc::size(m_veckey);
+				auto const pkey = tc::ptr_begin(m_veckey);
+				// Four levels below node k are its 16 descendants 16k to 16k+15. Prefetching is only a hint, so the
+				// address may lie beyond the end of the keys. Do the arithmetic on integers to avoid undefined behavior.
+				std::size_t k = 1;
+				while( k < n ) {
+					static_search_index_detail::prefetch(reinterpret_cast<void const*>(reinterpret_cast<std::uintptr_t>(pkey) + 16 * k * sizeof(key_type)));
+					k = 2 * k + (pred(pkey[k]) ? 1 : 0);
+				}
+				// The path to k encodes the decisions in its bits. Strip the trailing right turns and the final left turn.
+				return k >> (std::countr_one(k) + 1);
+			}
+
+			template<typename RangeReturn>
+			decltype(auto) pack_node(std::size_t k) const& noexcept {
+				return RangeReturn::pack_border(tc::begin(*m_rng) + m_vecnIndex[k], *m_rng);
+			}
+
+		public:
+			explicit static_search_index(Rng&& rng, Less less = Less()) noexcept
+				: m_rng(aggregate_tag, std::forward<Rng>(rng))
+				, m_less(tc_move(less))
+			{
+				static_assert( std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<tc::iterator_t<Rng const>>::iterator_category>::value );
+				_ASSERTDEBUG( tc::is_sorted(*m_rng, m_less) );
+				auto const n = tc::size(*m_rng);
+				m_veckey.resize(n + 1);
+				m_vecnIndex.resize(n + 1);
+				m_vecnIndex[0] = n;
+				auto it = tc::begin(*m_rng);
+				std::size_t nIndex = 0;
+				build(1, it, nIndex);
+			}
+
+			// Like tc::lower_bound<RangeReturn>(rng, t, less).
+			template<typename RangeReturn, typename T>
+			[[nodiscard]] decltype(auto) lower_bound(T const& t) const& noexcept {
+				static_assert( RangeReturn::allowed_if_always_has_border );
+				return pack_node<RangeReturn>(descend([&](key_type const& key) noexcept { return m_less(key, t); }));
+			}
+
+			// Like tc::upper_bound<RangeReturn>(rng, t, less).
+			template<typename RangeReturn, typename T>
+			[[nodiscard]] decltype(auto) upper_bound(T const& t) const& noexcept {
+				static_assert( RangeReturn::allowed_if_always_has_border );
+				return pack_node<RangeReturn>(descend([&](key_type const& key) noexcept { return !m_less(t, key); }));
+			}
+
+			// Like tc::binary_find_first<RangeReturn>(rng, t, less). The comparison with t is done on the index's own copy of the key.
+			template<typename RangeReturn, typename T>
+			[[nodiscard]] decltype(auto) binary_find_first(T const& t) const& noexcept {
+				auto const k = descend([&](key_type const& key) noexcept { return m_less(key, t); });
+				if( 0 == k || m_less(t, m_veckey[k]) ) {
+					return RangeReturn::pack_no_element(*m_rng);
+				} else {
+					auto it = tc::begin(*m_rng) + m_vecnIndex[k];
+					auto&& ref = *it;
+					return RangeReturn::pack_element(tc_move(it), *m_rng, tc_move_if_owned(ref));
+				}
+			}
+
+			// Like tc::binary_find_unique<RangeReturn>(rng, t, less).
+			template<typename RangeReturn, typename T>
+			[[nodiscard]] decltype(auto) binary_find_unique(T const& t) const& noexcept {
+#ifdef _CHECKS
+				if( auto const k = descend([&](key_type const& key) noexcept { return m_less(key, t); }); 0 != k && !m_less(t, m_veckey[k]) ) {
+					auto const nIndexNext = m_vecnIndex[k] + 1;
+					_ASSERT( tc::size(*m_rng) == nIndexNext || m_less(t, tc::at(*m_rng, nIndexNext)) );
+				}
+#endif
+				return binary_find_first<RangeReturn>(t);
+			}
+
+			// Like tc::binary_closest(rng, t).
+			template<typename T>
+			[[nodiscard]] auto binary_closest(T const& t) const& noexcept {
+				auto const nIndex = m_vecnIndex[descend([&](key_type const& key) noexcept { return m_less(key, t); })];
+				auto it = tc::begin(*m_rng) + nIndex;
+				if( 0 == nIndex ) {
+					return it;
+				} else if( tc::size(*m_rng) == nIndex ) {
+					return tc_modified(it, --_);
+				} else {
+					auto itPrior = tc_modified(it, --_);
+					return (t - *itPrior) < (*it - t) ? itPrior : it;
+				}
+			}
+
+			decltype(auto) base_range() const& noexcept {
+				return *m_rng;
+			}
+		};
+
+		template<typename Rng>
+		static_search_index(Rng&&) -> static_search_index<Rng>;
+		template<typename Rng, typename Less>
+		static_search_index(Rng&&, Less) -> static_search_index<Rng, Less>;
+	}
+	using static_search_index_adl::static_search_index;
+}
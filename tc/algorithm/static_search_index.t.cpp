@@ -0,0 +1,39 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../range/iota_range.h"
+#include "static_search_index.h"
+
+UNITTESTDEF(static_search_index_matches_binary_search) {
+	for( int n = 0; n < 70; ++n ) {
+		tc::vector<int> vecn;
+		for( int i = 0; i < n; ++i ) tc::cont_emplace_back(vecn, 2 * i + (i / 5)); // sorted, with gaps
+		tc::static_search_index const index(vecn);
+		for( int t = -2; t < 2 * n + n / 5 + 2; ++t ) {
+			_ASSERTEQUAL( index.lower_bound<tc::return_border>(t), tc::lower_bound<tc::return_border>(vecn, t) );
+			_ASSERTEQUAL( index.upper_bound<tc::return_border>(t), tc::upper_bound<tc::return_border>(vecn, t) );
+			_ASSERTEQUAL( index.binary_find_unique<tc::return_element_or_null>(t), tc::binary_find_unique<tc::return_element_or_null>(vecn, t) );
+			_ASSERTEQUAL( index.binary_find_first<tc::return_element_or_null>(t), tc::binary_find_first<tc::return_element_or_null>(vecn, t) );
+			if( 0 < n ) {
+				_ASSERTEQUAL( index.binary_closest(t), tc::binary_closest(vecn, t) );
+			}
+		}
+	}
+}
+
+UNITTESTDEF(static_search_index_duplicates) {
+	tc::vector<int> const vecn{1, 3, 3, 3, 5};
+	tc::static_search_index const index(vecn, tc::fn_less());
+	_ASSERTEQUAL( index.lower_bound<tc::return_border_index>(3), 1 );
+	_ASSERTEQUAL( index.upper_bound<tc::return_border_index>(3), 4 );
+	_ASSERTEQUAL( index.binary_find_first<tc::return_element_index>(3), 1 );
+	_ASSERT( !index.binary_find_first<tc::return_element_or_null>(4) );
+	_ASSERTEQUAL( tc::begin(index.base_range()), tc::begin(vecn) );
+}
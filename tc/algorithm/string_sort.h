@@ -0,0 +1,176 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../container/container.h"
+#include "../container/cont_reserve.h"
+#include "../container/string.h"
+#include "algorithm.h"
+
+#include <cstdint>
+#include <limits>
+
+namespace tc {
+	namespace string_sort_detail {
+		template<typename Char>
+		struct string_ref final {
+			Char const* m_pch;
+			std::size_t m_n;
+			std::size_t m_nPosition; // position in the original range
+		};
+
+		// Characters widened such that the end of a string sorts before every character.
+		// Characters compare by their value, like tc::char_traits<Char>::lt.
+		template<typename Char>
+		using key_t = std::conditional_t<sizeof(Char) < sizeof(int), int, std::int64_t>;
+
+		template<typename Char>
+		inline constexpr key_t<Char> c_keyEnd = std::numeric_limits<key_t<Char>>::min();
+
+		template<typename Char>
+		key_t<Char> key_at(string_ref<Char> const& str, std::size_t nDepth) noexcept {
+			return nDepth < str.m_n ? static_cast<key_t<Char>>(str.m_pch[nDepth]) : c_keyEnd<Char>;
+		}
+
+		// Length of the common prefix of lhs and rhs, which are known to agree in the first nDepth characters.
+		template<typename Char>
+		std::size_t common_prefix(string_ref<Char> const& lhs, string_ref<Char> const& rhs, std::size_t nDepth) noexcept {
+			auto const n = tc::min(lhs.m_n, rhs.m_n);
+			while( nDepth < n && lhs.m_pch[nDepth] == rhs.m_pch[nDepth] ) ++nDepth;
+			return nDepth;
+		}
+
+		// Below this size, insertion sort beats partitioning.
+		inline constexpr std::size_t c_nInsertionSortSize = 16;
+
+		// Sorts strings sharing their first nDepth characters. Comparisons start at nDepth, so common prefixes are not compared again.
+		// If pnLcp is not null, pnLcp[i] receives the length of the common prefix of the strings at i - 1 and i, for 0 < i < n.
+		template<typename Char>
+		void insertion_sort(string_ref<Char>* const pstr, std::size_t const n, std::size_t const nDepth, std::size_t* const pnLcp) noexcept {
+			for( std::size_t i = 1; i < n; ++i ) {
+				auto const str = pstr[i];
+				std::size_t j = i;
+				for( ; 0 < j; --j ) {
+					auto const nCommon = common_prefix(pstr[j - 1], str, nDepth);
+					if( key_at(pstr[j - 1], nCommon) <= key_at(str, nCommon) ) break; // equal strings keep their order
+					pstr[j] = pstr[j - 1];
+				}
+				pstr[j] = str;
+			}
+			if( pnLcp ) {
+				for( std::size_t i = 1; i < n; ++i ) {
+					pnLcp[i] = common_prefix(pstr[i - 1], pstr[i], nDepth);
+				}
+			}
+		}
+
+		// Multikey quicksort (Bentley and Sedgewick): three-way partitioning on the character at nDepth, then the strings
+		// with characters less or greater than the pivot are sorted at the same depth, and those equal to it at the next depth.
+		// Each character is inspected O(log n) times on average instead of once per comparison of a comparison sort.
+		template<typename Char>
+		void multikey_quicksort(string_ref<Char>* pstr, std::size_t n, std::size_t nDepth, std::size_t* pnLcp) noexcept {
+			while( c_nInsertionSortSize < n ) {
+				auto const Key = [&](std::size_t i) noexcept { return key_at(pstr[i], nDepth); };
+				auto const keyPivot = [&]() noexcept { // median of three
+					auto const key0 = Key(0);
+					auto const key1 = Key(n / 2);
+					auto const key2 = Key(n - 1);
+					return key0 < key1 ? (key1 < key2 ? key1 : tc::max(key0, key2)) : (key0 < key2 ? key0 : tc::max(key1, key2));
+				}();
+
+				// [0, nLess) < pivot, [nLess, i) == pivot, [nGreater, n) > pivot
+				std::size_t nLess = 0;
+				std::size_t i = 0;
+				std::size_t nGreater = n;
+				while( i < nGreater ) {
+					auto const key = Key(i);
+					if( key < keyPivot ) {
+						std::swap(pstr[nLess], pstr[i]);
+						++nLess;
+						++i;
+					} else if( keyPivot < key ) {
+						--nGreater;
+						std::swap(pstr[i], pstr[nGreater]);
+					} else {
+						++i;
+					}
+				}
+
+				// Strings in different partitions agree in exactly the first nDepth characters.
+				if( pnLcp ) {
+					if( 0 < nLess ) pnLcp[nLess] = nDepth;
+					if( nGreater < n ) pnLcp[nGreater] = nDepth;
+				}
+				multikey_quicksort(pstr, nLess, nDepth, pnLcp);
+				multikey_quicksort(pstr + nGreater, n - nGreater, nDepth, pnLcp ? pnLcp + nGreater : nullptr);
+
+				if( c_keyEnd<Char> == keyPivot ) {
+					// The strings equal to the pivot all end at nDepth, so they are equal.
+					if( pnLcp ) {
+						for( std::size_t j = nLess + 1; j < nGreater; ++j ) pnLcp[j] = nDepth;
+					}
+					return;
+				}
+				pstr += nLess;
+				if( pnLcp ) pnLcp += nLess;
+				n = nGreater - nLess;
+				++nDepth;
+			}
+			insertion_sort(pstr, n, nDepth, pnLcp);
+		}
+
+		template<typename Rng>
+		auto string_refs(Rng const& rng) noexcept {
+			using char_t = std::remove_cv_t<std::remove_pointer_t<decltype(tc::ptr_begin(tc::front(rng)))>>;
+			tc::vector<string_ref<char_t>> vecstr;
+			tc::cont_reserve(vecstr, tc::size(rng));
+			tc::for_each(rng, [&](auto const& str) noexcept {
+				tc::cont_emplace_back(vecstr, string_ref<char_t>{tc::ptr_begin(str), tc::size(str), tc::size(vecstr)});
+			});
+			return vecstr;
+		}
+
+		template<typename Rng, typename VecStr>
+		void apply_order(Rng&& rng, VecStr const& vecstr) noexcept {
+			auto vecn = tc::make_vector(tc::transform(vecstr, tc_member(.m_nPosition)));
+			sort_cached_key_detail::permute_inplace(rng, vecn);
+		}
+	}
+
+	// Sorts a random-access range of contiguous strings, e.g., tc::string<char> or tc::span<tc::char16 const>, into the same order
+	// as tc::sort_inplace(rng, tc::lessfrom3way(tc::fn_lexicographical_compare_3way())), i.e., characters compare like tc::char_traits<Char>::lt.
+	// Uses multikey quicksort, which does not compare common prefixes repeatedly, and insertion sort for small buckets.
+	// The strings themselves are moved once at the end.
+	template<typename Rng>
+	void string_sort_inplace(Rng&& rng) noexcept {
+		static_assert( tc::random_access_range<Rng> );
+		auto vecstr = string_sort_detail::string_refs(rng);
+		string_sort_detail::multikey_quicksort(tc::ptr_begin(vecstr), tc::size(vecstr), 0, nullptr);
+		string_sort_detail::apply_order(rng, vecstr);
+	}
+
+	// Like tc::string_sort_inplace, and returns the LCP array as a by-product: the element at i is the length of the longest common
+	// prefix of the sorted strings at i - 1 and i, and 0 for i = 0.
+	template<typename Rng>
+	[[nodiscard]] tc::vector<std::size_t> string_sort_inplace_lcp(Rng&& rng) noexcept {
+		static_assert( tc::random_access_range<Rng> );
+		auto vecstr = string_sort_detail::string_refs(rng);
+		tc::vector<std::size_t> vecnLcp(tc::size(vecstr), 0);
+		string_sort_detail::multikey_quicksort(tc::ptr_begin(vecstr), tc::size(vecstr), 0, tc::ptr_begin(vecnLcp));
+		string_sort_detail::apply_order(rng, vecstr);
+		return vecnLcp;
+	}
+
+	template<typename Cont>
+	void string_sort_unique_inplace(Cont& cont) noexcept {
+		tc::string_sort_inplace(cont);
+		tc::adjacent_unique_inplace(cont, tc::fn_equal_to());
+	}
+}
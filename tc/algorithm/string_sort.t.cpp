@@ -0,0 +1,62 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "string_sort.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+	template<typename Char>
+	void test_string_sort(std::mt19937& gen, int nStrings, int nMaxLength, tc::vector<Char> const& vecchAlphabet) noexcept {
+		std::uniform_int_distribution<int> distLength(0, nMaxLength);
+		std::uniform_int_distribution<std::size_t> distChar(0, tc::size(vecchAlphabet) - 1);
+		tc::vector<tc::string<Char>> vecstr;
+		for( int i = 0; i < nStrings; ++i ) {
+			tc::string<Char> str;
+			for( int n = distLength(gen); 0 < n; --n ) {
+				tc::cont_emplace_back(str, vecchAlphabet[distChar(gen)]);
+			}
+			tc::cont_emplace_back(vecstr, tc_move(str));
+		}
+
+		auto vecstrExpected = vecstr;
+		tc::sort_inplace(vecstrExpected, tc::lessfrom3way(tc::fn_lexicographical_compare_3way()));
+
+		auto vecstrSorted = vecstr;
+		tc::string_sort_inplace(vecstrSorted);
+		_ASSERT( tc::equal(vecstrSorted, vecstrExpected) );
+
+		auto const vecnLcp = tc::string_sort_inplace_lcp(vecstr);
+		_ASSERT( tc::equal(vecstr, vecstrExpected) );
+		_ASSERTEQUAL( tc::size(vecnLcp), tc::size(vecstr) );
+		for( std::size_t i = 1; i < tc::size(vecstr); ++i ) {
+			auto const& strPrev = vecstr[i - 1];
+			_ASSERTEQUAL( vecnLcp[i], tc::explicit_cast<std::size_t>(std::mismatch(tc::begin(strPrev), tc::end(strPrev), tc::begin(vecstr[i]), tc::end(vecstr[i])).first - tc::begin(strPrev)) );
+		}
+	}
+}
+
+UNITTESTDEF(string_sort) {
+	tc::vector<tc::string<char>> vecstr{"b", "ab", "", "abc", "a", "ab", "ba"};
+	auto const vecnLcp = tc::string_sort_inplace_lcp(vecstr);
+	_ASSERT( tc::equal(vecstr, tc::vector<tc::string<char>>{"", "a", "ab", "ab", "abc", "b", "ba"}) );
+	_ASSERT( tc::equal(vecnLcp, tc::vector<std::size_t>{0, 0, 1, 2, 2, 0, 1}) );
+
+	tc::string_sort_unique_inplace(vecstr);
+	_ASSERT( tc::equal(vecstr, tc::vector<tc::string<char>>{"", "a", "ab", "abc", "b", "ba"}) );
+
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	// Small alphabets make long common prefixes and many duplicates. Negative chars sort before positive ones, like tc::char_traits<char>.
+	test_string_sort<char>(gen, 2000, 12, tc::vector<char>{'a', 'b'});
+	test_string_sort<char>(gen, 2000, 40, tc::vector<char>{'/', 'a', 'b', 'c', static_cast<char>(-30), static_cast<char>(0x7f)});
+	test_string_sort<char>(gen, 10, 5, tc::vector<char>{'x', 'y', 'z'});
+	test_string_sort<tc::char16>(gen, 2000, 20, tc::vector<tc::char16>{u'a', u'b', 0xff, 0xfffe});
+}
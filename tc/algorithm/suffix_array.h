@@ -0,0 +1,276 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/reference_or_value.h"
+#include "../container/container.h"
+#include "../range/subrange.h"
+#include "algorithm.h"
+#include "longest_common_prefix.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace tc {
+	namespace suffix_array_detail {
+		inline constexpr std::size_t c_nEmpty = std::numeric_limits<std::size_t>::max();
+
+		// SA-IS (Nong, Zhang and Chan): sorts all suffixes of pn[0, n) in O(n), where pn[n - 1] == 0 is a unique sentinel
+		// and all characters are less than nAlphabet. Sorting the LMS substrings (those starting at an S-type character
+		// preceded by an L-type one) by induction reduces the problem to a string of at most n / 2 names, which is sorted recursively.
+		inline void sais(std::size_t const* const pn, std::size_t* const pnSuffix, std::size_t const n, std::size_t const nAlphabet) noexcept {
+			if( 1 == n ) {
+				pnSuffix[0] = 0;
+				return;
+			}
+			tc::vector<bool> vecbSType(n, false);
+			vecbSType[n - 1] = true;
+			for( std::size_t i = n - 1; 0 < i; --i ) {
+				vecbSType[i - 1] = pn[i - 1] < pn[i] || (pn[i - 1] == pn[i] && vecbSType[i]);
+			}
+			auto const IsLms = [&](std::size_t i) noexcept {
+				return 0 < i && vecbSType[i] && !vecbSType[i - 1];
+			};
+
+			tc::vector<std::size_t> vecnBucketSize(nAlphabet, 0);
+			for( std::size_t i = 0; i < n; ++i ) ++vecnBucketSize[pn[i]];
+			tc::vector<std::size_t> vecnBucket(nAlphabet);
+			auto const BucketBegins = [&]() noexcept {
+				std::size_t nSum = 0;
+				for( std::size_t c = 0; c < nAlphabet; ++c ) {
+					vecnBucket[c] = nSum;
+					nSum += vecnBucketSize[c];
+				}
+			};
+			auto const BucketEnds = [&]() noexcept {
+				std::size_t nSum = 0;
+				for( std::size_t c = 0; c < nAlphabet; ++c ) {
+					nSum += vecnBucketSize[c];
+					vecnBucket[c] = nSum;
+				}
+			};
+			// Given the sorted LMS suffixes at the ends of their buckets, induces the order of all suffixes.
+			auto const Induce = [&]() noexcept {
+				BucketBegins();
+				for( std::size_t i = 0; i < n; ++i ) {
+					if( c_nEmpty != pnSuffix[i] && 0 < pnSuffix[i] && !vecbSType[pnSuffix[i] - 1] ) {
+						auto const j = pnSuffix[i] - 1;
+						pnSuffix[vecnBucket[pn[j]]++] = j;
+					}
+				}
+				BucketEnds();
+				for( std::size_t i = n; 0 < i--; ) {
+					if( c_nEmpty != pnSuffix[i] && 0 < pnSuffix[i] && vecbSType[pnSuffix[i] - 1] ) {
+						auto const j = pnSuffix[i] - 1;
+						pnSuffix[--vecnBucket[pn[j]]] = j;
+					}
+				}
+			};
+
+			// Step 1: sort the LMS substrings.
+			std::fill(pnSuffix, pnSuffix + n, c_nEmpty);
+			BucketEnds();
+			for( std::size_t i = 1; i < n; ++i ) {
+				if( IsLms(i) ) pnSuffix[--vecnBucket[pn[i]]] = i;
+			}
+			Induce();
+
+			// Step 2: name the LMS substrings by rank, and sort the string of names recursively.
+			std::size_t nLms = 0;
+			for( std::size_t i = 0; i < n; ++i ) {
+				if( IsLms(pnSuffix[i]) ) pnSuffix[nLms++] = pnSuffix[i];
+			}
+			std::fill(pnSuffix + nLms, pnSuffix + n, c_nEmpty);
+			std::size_t nNames = 0;
+			std::size_t nPrev = c_nEmpty;
+			for( std::size_t i = 0; i < nLms; ++i ) {
+				auto const nPos = pnSuffix[i];
+				bool bDiffers = false;
+				for( std::size_t d = 0;; ++d ) {
+					if( c_nEmpty == nPrev || pn[nPos + d] != pn[nPrev + d] || vecbSType[nPos + d] != vecbSType[nPrev + d] ) {
+						bDiffers = true;
+						break;
+					} else if( 0 < d && (IsLms(nPos + d) || IsLms(nPrev + d)) ) {
+						break;
+					}
+				}
+				if( bDiffers ) {
+					++nNames;
+					nPrev = nPos;
+				}
+				pnSuffix[nLms + nPos / 2] = nNames - 1; // LMS positions are at least 2 apart
+			}
+			for( std::size_t i = n, j = n; nLms < i--; ) {
+				if( c_nEmpty != pnSuffix[i] ) pnSuffix[--j] = pnSuffix[i];
+			}
+
+			std::size_t* const pnReduced = pnSuffix + n - nLms;
+			if( nNames < nLms ) {
+				sais(pnReduced, pnSuffix, nLms, nNames);
+			} else {
+				for( std::size_t i = 0; i < nLms; ++i ) pnSuffix[pnReduced[i]] = i;
+			}
+
+			// Step 3: place the sorted LMS suffixes at the ends of their buckets and induce the rest.
+			for( std::size_t i = 1, j = 0; i < n; ++i ) {
+				if( IsLms(i) ) pnReduced[j++] = i;
+			}
+			for( std::size_t i = 0; i < nLms; ++i ) pnSuffix[i] = pnReduced[pnSuffix[i]];
+			std::fill(pnSuffix + nLms, pnSuffix + n, c_nEmpty);
+			BucketEnds();
+			for( std::size_t i = nLms; 0 < i--; ) {
+				auto const j = pnSuffix[i];
+				pnSuffix[i] = c_nEmpty;
+				pnSuffix[--vecnBucket[pn[j]]] = j;
+			}
+			Induce();
+		}
+
+		// Maps the elements of rng to ranks 1, 2, ... preserving tc::less, followed by the sentinel 0. Returns the alphabet size.
+		// Characters of at most 16 bits are ranked by a table in O(n), other elements by sorting the distinct values.
+		template<typename Rng>
+		std::size_t ranks(Rng const& rng, tc::vector<std::size_t>& vecn) noexcept {
+			using value_t = tc::range_value_t<Rng const&>;
+			tc::cont_reserve(vecn, tc::size(rng) + 1);
+			std::size_t nAlphabet;
+			if constexpr( std::is_integral<value_t>::value && sizeof(value_t) <= 2 ) {
+				auto const Offset = [](value_t const val) noexcept {
+					return tc::explicit_cast<std::size_t>(static_cast<int>(val) - std::numeric_limits<value_t>::min());
+				};
+				tc::vector<std::size_t> vecnRank(std::size_t(1) << (8 * sizeof(value_t)), 0);
+				tc::for_each(rng, [&](value_t const val) noexcept { vecnRank[Offset(val)] = 1; });
+				nAlphabet = 1;
+				for( auto& nRank : vecnRank ) {
+					if( 0 != nRank ) nRank = nAlphabet++;
+				}
+				tc::for_each(rng, [&](value_t const val) noexcept { tc::cont_emplace_back(vecn, vecnRank[Offset(val)]); });
+			} else {
+				auto vecval = tc::make_vector(rng);
+				tc::sort_unique_inplace(vecval);
+				tc::for_each(rng, [&](auto const& val) noexcept {
+					tc::cont_emplace_back(vecn, tc::explicit_cast<std::size_t>(tc::lower_bound<tc::return_border>(vecval, val) - tc::begin(vecval)) + 1);
+				});
+				nAlphabet = tc::size(vecval) + 1;
+			}
+			tc::cont_emplace_back(vecn, 0);
+			return nAlphabet;
+		}
+	}
+
+	namespace suffix_array_adl {
+		// Suffix array of a random-access range of characters or integers: the start positions of all suffixes in lexicographical order,
+		// with elements compared by tc::less, so chars compare like tc::char_traits<char>. Built by SA-IS in O(n) time.
+		// Finding all occurrences of a pattern of length m takes O(m log n).
+		template<typename Rng>
+		struct [[nodiscard]] suffix_array final {
+		private:
+			tc::reference_or_value<Rng> m_rng;
+			tc::vector<std::size_t> m_vecnSuffix;
+
+			// Compares the suffix at nPos, truncated to the size of rngPattern, with rngPattern.
+			template<typename RngPattern>
+			std::weak_ordering compare_prefix(std::size_t const nPos, RngPattern const& rngPattern) const& noexcept {
+				auto itSuffix = tc::begin(*m_rng) + nPos;
+				auto const itSuffixEnd = tc::end(*m_rng);
+				auto const itPatternEnd = tc::end(rngPattern);
+				for( auto itPattern = tc::begin(rngPattern); itPattern != itPatternEnd; ++itPattern, ++itSuffix ) {
+					if( itSuffixEnd == itSuffix || tc::less(*itSuffix, *itPattern) ) return std::weak_ordering::less;
+					if( tc::less(*itPattern, *itSuffix) ) return std::weak_ordering::greater;
+				}
+				return std::weak_ordering::equivalent;
+			}
+
+		public:
+			explicit suffix_array(Rng&& rng) noexcept
+				: m_rng(aggregate_tag, std::forward<Rng>(rng))
+			{
+				static_assert( tc::random_access_range<Rng const> );
+				tc::vector<std::size_t> vecn;
+				auto const nAlphabet = suffix_array_detail::ranks(*m_rng, vecn);
+				m_vecnSuffix.resize(tc::size(vecn));
+				suffix_array_detail::sais(tc::ptr_begin(vecn), tc::ptr_begin(m_vecnSuffix), tc::size(vecn), nAlphabet);
+				_ASSERTEQUAL( tc::front(m_vecnSuffix), tc::size(*m_rng) ); // the sentinel suffix comes first
+				m_vecnSuffix.erase(tc::begin(m_vecnSuffix));
+			}
+
+			tc::vector<std::size_t> const& suffixes() const& noexcept {
+				return m_vecnSuffix;
+			}
+
+			// LCP array by Kasai's algorithm in O(n): the element at i is the length of the longest common prefix of the suffixes
+			// at suffixes()[i - 1] and suffixes()[i], and 0 for i = 0.
+			[[nodiscard]] tc::vector<std::size_t> lcp_array() const& noexcept {
+				auto const n = tc::size(m_vecnSuffix);
+				tc::vector<std::size_t> vecnRank(n);
+				for( std::size_t i = 0; i < n; ++i ) vecnRank[m_vecnSuffix[i]] = i;
+				tc::vector<std::size_t> vecnLcp(n, 0);
+				auto const it = tc::begin(*m_rng);
+				auto const itEnd = tc::end(*m_rng);
+				std::size_t nLcp = 0;
+				for( std::size_t nPos = 0; nPos < n; ++nPos ) {
+					if( 0 == vecnRank[nPos] ) {
+						nLcp = 0;
+					} else {
+						// The suffix at nPos + 1 shares at least nLcp - 1 characters with its predecessor.
+						auto const nPosPrev = m_vecnSuffix[vecnRank[nPos] - 1];
+						auto const itLcp = tc::longest_common_prefix<tc::return_border>(
+							tc::make_iterator_range(it + (nPos + nLcp), itEnd),
+							tc::make_iterator_range(it + (nPosPrev + nLcp), itEnd)
+						).first;
+						nLcp = tc::explicit_cast<std::size_t>(itLcp - it) - nPos;
+						vecnLcp[vecnRank[nPos]] = nLcp;
+						if( 0 < nLcp ) --nLcp;
+					}
+				}
+				return vecnLcp;
+			}
+
+			// The start positions of all occurrences of rngPattern, in the order of suffixes().
+			template<typename RngPattern>
+			[[nodiscard]] auto equal_range(RngPattern const& rngPattern) const& noexcept {
+				auto const itBegin = tc::iterator::partition_point(tc::begin(m_vecnSuffix), tc::end(m_vecnSuffix), [&](std::size_t nPos) noexcept {
+					return std::is_lt(compare_prefix(nPos, rngPattern));
+				});
+				auto const itEnd = tc::iterator::partition_point(itBegin, tc::end(m_vecnSuffix), [&](std::size_t nPos) noexcept {
+					return !std::is_gt(compare_prefix(nPos, rngPattern));
+				});
+				return tc::make_iterator_range(itBegin, itEnd);
+			}
+
+			// Like tc::search_first<RangeReturn>(base_range(), rngPattern).
+			template<typename RangeReturn, typename RngPattern>
+			[[nodiscard]] decltype(auto) search_first(RngPattern const& rngPattern) const& noexcept {
+				auto const rngn = equal_range(rngPattern);
+				if( tc::empty(rngn) ) {
+					return RangeReturn::pack_no_element(*m_rng);
+				} else {
+					auto const itBegin = tc::begin(*m_rng) + tc::min_element<tc::return_value>(rngn);
+					return RangeReturn::pack_view(*m_rng, itBegin, itBegin + tc::size(rngPattern));
+				}
+			}
+
+			// The start positions of all occurrences of rngPattern, in ascending order.
+			template<typename RngPattern>
+			[[nodiscard]] tc::vector<std::size_t> search_all(RngPattern const& rngPattern) const& noexcept {
+				auto vecn = tc::make_vector(equal_range(rngPattern));
+				tc::sort_inplace(vecn);
+				return vecn;
+			}
+
+			decltype(auto) base_range() const& noexcept {
+				return *m_rng;
+			}
+		};
+
+		template<typename Rng>
+		suffix_array(Rng&&) -> suffix_array<Rng>;
+	}
+	using suffix_array_adl::suffix_array;
+}
@@ -0,0 +1,73 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "suffix_array.h"
+#include "../range/iota_range.h"
+
+#include <random>
+
+namespace {
+	template<typename Rng>
+	void test_suffix_array(Rng const& rng) noexcept {
+		tc::suffix_array const sa(rng);
+		auto const n = tc::size(rng);
+		_ASSERTEQUAL( tc::size(sa.suffixes()), n );
+
+		// Compare with sorting the suffixes directly.
+		auto vecnExpected = tc::make_vector(tc::iota(std::size_t(0), n));
+		tc::sort_inplace(vecnExpected, [&](std::size_t nLhs, std::size_t nRhs) noexcept {
+			return std::is_lt(tc::lexicographical_compare_3way(tc::begin_next<tc::return_drop>(rng, nLhs), tc::begin_next<tc::return_drop>(rng, nRhs)));
+		});
+		_ASSERT( tc::equal(sa.suffixes(), vecnExpected) );
+
+		auto const vecnLcp = sa.lcp_array();
+		for( std::size_t i = 1; i < n; ++i ) {
+			_ASSERTEQUAL( vecnLcp[i], tc::size(tc::longest_common_prefix<tc::return_take>(tc::begin_next<tc::return_drop>(rng, vecnExpected[i - 1]), tc::begin_next<tc::return_drop>(rng, vecnExpected[i])).first) );
+		}
+	}
+}
+
+UNITTESTDEF(suffix_array) {
+	tc::suffix_array const sa("banana");
+	_ASSERT( tc::equal(sa.suffixes(), tc::vector<std::size_t>{5, 3, 1, 0, 4, 2}) );
+	_ASSERT( tc::equal(sa.lcp_array(), tc::vector<std::size_t>{0, 1, 3, 0, 0, 2}) );
+	_ASSERT( tc::equal(sa.search_all("ana"), tc::vector<std::size_t>{1, 3}) );
+	_ASSERT( tc::equal(sa.search_all("a"), tc::vector<std::size_t>{1, 3, 5}) );
+	_ASSERT( tc::empty(sa.search_all("nab")) );
+	_ASSERT( tc::empty(sa.search_all("banana!")) );
+	_ASSERTEQUAL( tc::size(sa.equal_range("")), 6 );
+	auto const orngch = sa.search_first<tc::return_view_or_none>("na");
+	_ASSERT( orngch );
+	_ASSERTEQUAL( tc::begin(*orngch), tc::begin(sa.base_range()) + 2 );
+	_ASSERT( tc::equal(*orngch, "na") );
+	_ASSERT( !sa.search_first<tc::return_bool>("x") );
+
+	test_suffix_array(tc::string<char>());
+	test_suffix_array(tc::string<char>("a"));
+	test_suffix_array(tc::string<char>("mississippi"));
+	test_suffix_array(tc::string<char>("aaaaaaaaaaaaaaaa"));
+	test_suffix_array(tc::string<char>("abababababababab\xff\x7f"));
+
+	std::mt19937 gen; // same sequence of numbers each time for reproducibility
+	for( int nAlphabet : {2, 3, 26} ) {
+		std::uniform_int_distribution<int> dist(0, nAlphabet - 1);
+		tc::string<char> str;
+		tc::vector<int> vecn;
+		tc::vector<tc::char16> vecch;
+		for( int i = 0; i < 1000; ++i ) {
+			tc::cont_emplace_back(str, static_cast<char>('a' + dist(gen)));
+			tc::cont_emplace_back(vecn, dist(gen) * 1000000 - 3000000);
+			tc::cont_emplace_back(vecch, static_cast<tc::char16>(0xfff0 + dist(gen)));
+		}
+		test_suffix_array(str);
+		test_suffix_array(vecn);
+		test_suffix_array(vecch);
+	}
+}
@@ -57,4 +57,15 @@ MODIFY_WARNINGS_END
 			return Uint{1} << tc::index_of_most_significant_bit(u);
 		}
 	}
+
+	// Bit i of the result is the parity of the bits 0 to i of u, e.g., to mark the bytes between pairs of quotes
+	// given a bit mask of the quotes.
+	template<typename Uint>
+	[[nodiscard]] constexpr Uint prefix_xor(Uint u) noexcept {
+		static_assert( std::is_unsigned<Uint>::value );
+		for( int nShift = 1; nShift < std::numeric_limits<Uint>::digits; nShift *= 2 ) {
+			u ^= u << nShift;
+		}
+		return u;
+	}
 }
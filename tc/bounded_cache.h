@@ -0,0 +1,222 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "base/assert_defs.h"
+#include "base/assign.h"
+#include "base/noncopyable.h"
+#include "container/container.h"
+#include "container/insert.h"
+#include "container/cont_reserve.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace tc {
+	namespace bounded_cache_adl {
+		// Memoization cache holding at most capacity() entries, as replacement for tc::map_query_cache and
+		// tc::multi_index_try_emplace_with_key on an unbounded hashed index in long-running processes.
+		// When full, inserting evicts an entry not recently used, chosen by the CLOCK algorithm: every hit sets a reference bit,
+		// and the clock hand clears the bits of the entries it passes until it finds one whose bit is clear.
+		// All memory is allocated by the constructor. Entries live in a flat array, which is indexed by an open-addressing hash table
+		// with linear probing and backward-shift deletion, so neither lookups nor evictions allocate.
+		// References to values stay valid until the entry is evicted, i.e., until the next insertion.
+		template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = tc::fn_equal_to>
+		struct [[nodiscard]] bounded_cache final : tc::noncopyable {
+		private:
+			struct entry final {
+				template<typename K, typename... Args>
+				entry(std::size_t nHash, K&& key, Args&&... args) MAYTHROW
+					: m_nHash(nHash)
+					, m_key(std::forward<K>(key))
+					, m_value(std::forward<Args>(args)...)
+				{}
+
+				std::size_t m_nHash;
+				Key m_key;
+				Value m_value;
+				bool m_bReferenced = false;
+			};
+
+			static constexpr std::uint32_t c_nEmpty = std::numeric_limits<std::uint32_t>::max();
+
+			tc::vector<std::optional<entry>> m_vecoentry; // reserved to capacity, never reallocates
+			tc::vector<std::uint32_t> m_vecnIndex; // power of two size, at most half full
+			tc::vector<std::uint32_t> m_vecnFree; // slots in m_vecoentry emptied by erase
+			std::size_t m_nCapacity;
+			std::size_t m_nSize = 0;
+			std::size_t m_nClockHand = 0;
+			std::size_t m_nHits = 0;
+			std::size_t m_nMisses = 0;
+			std::size_t m_nEvictions = 0;
+			[[no_unique_address]] Hash m_hash;
+			[[no_unique_address]] KeyEqual m_equal;
+
+			std::size_t mask() const& noexcept {
+				return tc::size(m_vecnIndex) - 1;
+			}
+
+			// Returns the position in m_vecnIndex holding the entry with key, or the empty position where it would be inserted.
+			template<typename K>
+			std::size_t find_position(std::size_t nHash, K const& key) const& noexcept {
+				for( std::size_t nPos = nHash & mask();; nPos = (nPos + 1) & mask() ) {
+					auto const nEntry = m_vecnIndex[nPos];
+					if( c_nEmpty == nEntry ) return nPos;
+					auto const& oentry = m_vecoentry[nEntry];
+					if( oentry->m_nHash == nHash && tc::invoke(m_equal, oentry->m_key, key) ) return nPos;
+				}
+			}
+
+			void erase_position(std::size_t nPos) & noexcept {
+				// Backward-shift deletion keeps probe sequences intact without tombstones.
+				for( std::size_t nPosNext = (nPos + 1) & mask();; nPosNext = (nPosNext + 1) & mask() ) {
+					auto const nEntry = m_vecnIndex[nPosNext];
+					if( c_nEmpty == nEntry ) break;
+					auto const nPosHome = m_vecoentry[nEntry]->m_nHash & mask();
+					// Move the entry at nPosNext into the hole if the hole lies cyclically in [nPosHome, nPosNext).
+					if( ((nPosNext - nPosHome) & mask()) >= ((nPosNext - nPos) & mask()) ) {
+						m_vecnIndex[nPos] = nEntry;
+						nPos = nPosNext;
+					}
+				}
+				m_vecnIndex[nPos] = c_nEmpty;
+			}
+
+			// Returns the index of an unused slot in m_vecoentry, evicting an entry if the cache is full.
+			std::size_t free_slot() & noexcept {
+				if( !tc::empty(m_vecnFree) ) {
+					auto const nEntry = tc::back(m_vecnFree);
+					m_vecnFree.pop_back();
+					return nEntry;
+				}
+				if( tc::size(m_vecoentry) < m_nCapacity ) {
+					tc::cont_emplace_back(m_vecoentry);
+					return tc::size(m_vecoentry) - 1;
+				}
+				for(;;) {
+					auto const nEntry = m_nClockHand;
+					m_nClockHand = (m_nClockHand + 1) % m_nCapacity;
+					auto& oentry = m_vecoentry[nEntry];
+					if( !oentry ) return nEntry; // left empty by a throwing constructor
+					if( !tc::change(oentry->m_bReferenced, false) ) {
+						erase_position(find_position(oentry->m_nHash, oentry->m_key));
+						oentry.reset();
+						--m_nSize;
+						++m_nEvictions;
+						return nEntry;
+					}
+				}
+			}
+
+		public:
+			explicit bounded_cache(std::size_t nCapacity, Hash hash = Hash(), KeyEqual equal = KeyEqual()) noexcept
+				: m_vecnIndex(std::bit_ceil(2 * nCapacity), c_nEmpty)
+				, m_nCapacity(nCapacity)
+				, m_hash(tc_move(hash))
+				, m_equal(tc_move(equal))
+			{
+				_ASSERT( 0 < nCapacity && nCapacity < c_nEmpty );
+				tc::cont_reserve(m_vecoentry, nCapacity);
+				tc::cont_reserve(m_vecnFree, nCapacity);
+			}
+
+			// Like tc::multi_index_try_emplace_with_key: returns the cached value for key and false if present,
+			// otherwise constructs the value from args, inserts it, and returns it and true.
+			template<typename K, typename... Args>
+			std::pair<Value&, bool> try_emplace_with_key(K&& key, Args&&... args) & MAYTHROW {
+				auto const nHash = tc::invoke(m_hash, tc::as_const(key));
+				if( auto const nEntry = m_vecnIndex[find_position(nHash, key)]; c_nEmpty != nEntry ) {
+					++m_nHits;
+					auto& oentry = m_vecoentry[nEntry];
+					oentry->m_bReferenced = true;
+					return {oentry->m_value, false};
+				}
+				++m_nMisses;
+				auto const nEntry = free_slot();
+				auto const nPos = find_position(nHash, key); // eviction may have shifted the index
+				auto& entryNew = m_vecoentry[nEntry].emplace(nHash, std::forward<K>(key), std::forward<Args>(args)...); // MAYTHROW
+				m_vecnIndex[nPos] = tc::explicit_cast<std::uint32_t>(nEntry);
+				++m_nSize;
+				return {entryNew.m_value, true};
+			}
+
+			// Like tc::map_query_cache: func(key) computes the value on a miss.
+			template<typename K, typename Func>
+			Value& query(K&& key, Func&& func) & MAYTHROW {
+				auto const nHash = tc::invoke(m_hash, tc::as_const(key));
+				auto const nPos = find_position(nHash, key);
+				if( c_nEmpty != m_vecnIndex[nPos] ) {
+					++m_nHits;
+					auto& oentry = m_vecoentry[m_vecnIndex[nPos]];
+					oentry->m_bReferenced = true;
+					return oentry->m_value;
+				}
+				auto value = tc::invoke(std::forward<Func>(func), tc::as_const(key)); // MAYTHROW
+				return try_emplace_with_key(std::forward<K>(key), tc_move(value)).first; // MAYTHROW
+			}
+
+			// Returns the cached value without counting a hit or miss and without marking it as recently used.
+			template<typename K>
+			Value* find(K const& key) & noexcept {
+				auto const nEntry = m_vecnIndex[find_position(tc::invoke(m_hash, key), key)];
+				return c_nEmpty == nEntry ? nullptr : std::addressof(m_vecoentry[nEntry]->m_value);
+			}
+
+			template<typename K>
+			bool erase(K const& key) & noexcept {
+				auto const nPos = find_position(tc::invoke(m_hash, key), key);
+				auto const nEntry = m_vecnIndex[nPos];
+				if( c_nEmpty == nEntry ) return false;
+				erase_position(nPos);
+				m_vecoentry[nEntry].reset();
+				tc::cont_emplace_back(m_vecnFree, tc::explicit_cast<std::uint32_t>(nEntry));
+				--m_nSize;
+				return true;
+			}
+
+			void clear() & noexcept {
+				m_vecoentry.clear();
+				m_vecnFree.clear();
+				std::fill(tc::begin(m_vecnIndex), tc::end(m_vecnIndex), c_nEmpty);
+				m_nSize = 0;
+				m_nClockHand = 0;
+			}
+
+			std::size_t size() const& noexcept {
+				return m_nSize;
+			}
+			bool empty() const& noexcept {
+				return 0 == m_nSize;
+			}
+			std::size_t capacity() const& noexcept {
+				return m_nCapacity;
+			}
+
+			std::size_t hits() const& noexcept {
+				return m_nHits;
+			}
+			std::size_t misses() const& noexcept {
+				return m_nMisses;
+			}
+			std::size_t evictions() const& noexcept {
+				return m_nEvictions;
+			}
+		};
+	}
+	using bounded_cache_adl::bounded_cache;
+
+	template<typename Key, typename Value, typename Hash, typename KeyEqual, typename K, typename... Args>
+	std::pair<Value&, bool> multi_index_try_emplace_with_key(tc::bounded_cache<Key, Value, Hash, KeyEqual>& cache, K&& key, Args&&... args) MAYTHROW {
+		return cache.try_emplace_with_key(std::forward<K>(key), std::forward<Args>(args)...); // MAYTHROW
+	}
+}
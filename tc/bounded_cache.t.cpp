@@ -0,0 +1,63 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "base/assert_defs.h"
+#include "unittest.h"
+#include "bounded_cache.h"
+
+UNITTESTDEF(bounded_cache_clock) {
+	tc::bounded_cache<int, tc::string<char>> cache(3);
+	_ASSERT( cache.try_emplace_with_key(1, "a").second );
+	_ASSERT( cache.try_emplace_with_key(2, "b").second );
+	_ASSERT( cache.try_emplace_with_key(3, "c").second );
+	_ASSERTEQUAL( cache.size(), 3 );
+
+	auto const pairstrb = cache.try_emplace_with_key(1, "x");
+	_ASSERT( !pairstrb.second );
+	_ASSERTEQUAL( pairstrb.first, "a" );
+
+	// 1 was used recently, so the clock passes it and evicts 2.
+	_ASSERT( tc::multi_index_try_emplace_with_key(cache, 4, "d").second );
+	_ASSERTEQUAL( cache.size(), 3 );
+	_ASSERT( !cache.find(2) );
+	_ASSERTEQUAL( *cache.find(1), "a" );
+	_ASSERTEQUAL( *cache.find(3), "c" );
+	_ASSERTEQUAL( *cache.find(4), "d" );
+
+	_ASSERTEQUAL( cache.hits(), 1 );
+	_ASSERTEQUAL( cache.misses(), 4 );
+	_ASSERTEQUAL( cache.evictions(), 1 );
+
+	_ASSERT( cache.erase(3) );
+	_ASSERT( !cache.erase(3) );
+	_ASSERT( cache.try_emplace_with_key(5, "e").second ); // reuses the erased slot
+	_ASSERTEQUAL( cache.evictions(), 1 );
+
+	cache.clear();
+	_ASSERT( cache.empty() );
+	_ASSERT( !cache.find(1) );
+}
+
+UNITTESTDEF(bounded_cache_query) {
+	tc::bounded_cache<int, int> cache(16);
+	int nCalls = 0;
+	auto const square = [&](int n) noexcept { ++nCalls; return n * n; };
+	for( int i = 0; i < 1000; ++i ) {
+		_ASSERTEQUAL( cache.query(i % 20, square), (i % 20) * (i % 20) );
+		_ASSERT( cache.size() <= 16 );
+	}
+	_ASSERTEQUAL( cache.hits() + cache.misses(), 1000 );
+	_ASSERTEQUAL( tc::explicit_cast<std::size_t>(nCalls), cache.misses() );
+	_ASSERTEQUAL( cache.misses() - cache.evictions(), 16 );
+
+	for( int i = 0; i < 20; ++i ) {
+		if( auto const pn = cache.find(i) ) {
+			_ASSERTEQUAL( *pn, i * i );
+		}
+	}
+}
@@ -0,0 +1,194 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "base/assert_defs.h"
+#include "base/noncopyable.h"
+#include "algorithm/for_each.h"
+#include "algorithm/append.h"
+#include "algorithm/size.h"
+#include "range/subrange.h"
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <new>
+
+namespace tc {
+	namespace concurrent_vector_detail {
+		inline constexpr std::size_t c_nFirstSegmentSize = 16;
+
+		// Segment k holds the c_nFirstSegmentSize * 2^k elements starting at index c_nFirstSegmentSize * (2^k - 1).
+		inline constexpr int c_nSegments = std::numeric_limits<std::size_t>::digits - std::bit_width(c_nFirstSegmentSize) + 1;
+
+		constexpr int segment_of(std::size_t n) noexcept {
+			return std::bit_width(n / c_nFirstSegmentSize + 1) - 1;
+		}
+		constexpr std::size_t segment_begin(int nSegment) noexcept {
+			return c_nFirstSegmentSize * ((std::size_t(1) << nSegment) - 1);
+		}
+		constexpr std::size_t segment_size(int nSegment) noexcept {
+			return c_nFirstSegmentSize << nSegment;
+		}
+	}
+
+	namespace concurrent_vector_adl {
+		// Vector which multiple threads may grow concurrently without locking. Elements are stored in segments of doubling size,
+		// which are never moved, so references to elements stay valid while the vector grows.
+		// grow_by atomically reserves a block of indices and constructs the elements in place. tc::append into a concurrent_vector
+		// reserves once per chunk, so threads appending whole ranges do not interleave their elements.
+		// Elements may be accessed by other threads only after synchronizing with the thread which constructed them,
+		// e.g., by joining it. Element construction must not throw.
+		template<typename T>
+		struct [[nodiscard]] concurrent_vector final : tc::nonmovable {
+		private:
+			std::atomic<T*> m_apSegment[concurrent_vector_detail::c_nSegments] = {};
+			std::atomic<std::size_t> m_nSize = 0;
+
+			// Returns the segment, allocating it if no other thread did so before.
+			T* segment(int nSegment) & noexcept {
+				auto p = m_apSegment[nSegment].load(std::memory_order_acquire);
+				if( !p ) {
+					auto const pNew = static_cast<T*>(::operator new(concurrent_vector_detail::segment_size(nSegment) * sizeof(T), std::align_val_t(alignof(T))));
+					if( m_apSegment[nSegment].compare_exchange_strong(p, pNew, std::memory_order_acq_rel, std::memory_order_acquire) ) {
+						p = pNew;
+					} else {
+						::operator delete(pNew, std::align_val_t(alignof(T)));
+					}
+				}
+				return p;
+			}
+
+			// Calls func(p) with the uninitialized storage p of each element in [nBegin, nBegin + n), in order.
+			template<typename Func>
+			void for_each_slot(std::size_t nBegin, std::size_t const n, Func func) & noexcept {
+				std::size_t nEnd = nBegin + n;
+				while( nBegin != nEnd ) {
+					int const nSegment = concurrent_vector_detail::segment_of(nBegin);
+					auto const nSegmentBegin = concurrent_vector_detail::segment_begin(nSegment);
+					auto const nSegmentEnd = tc::min(nEnd, nSegmentBegin + concurrent_vector_detail::segment_size(nSegment));
+					auto p = segment(nSegment) + (nBegin - nSegmentBegin);
+					for( auto const pEnd = p + (nSegmentEnd - nBegin); p != pEnd; ++p ) {
+						func(p);
+					}
+					nBegin = nSegmentEnd;
+				}
+			}
+
+		public:
+			using value_type = T;
+			using reference = T&;
+			using const_reference = T const&;
+
+			concurrent_vector() noexcept = default;
+
+			~concurrent_vector() {
+				auto const n = size();
+				for( int nSegment = 0; nSegment < concurrent_vector_detail::c_nSegments; ++nSegment ) {
+					if( auto const p = m_apSegment[nSegment].load(std::memory_order_relaxed) ) {
+						auto const nSegmentBegin = concurrent_vector_detail::segment_begin(nSegment);
+						if( nSegmentBegin < n ) {
+							std::destroy_n(p, tc::min(n - nSegmentBegin, concurrent_vector_detail::segment_size(nSegment)));
+						}
+						::operator delete(p, std::align_val_t(alignof(T)));
+					}
+				}
+			}
+
+			// Appends n elements constructed from args and returns the index of the first one. Thread-safe.
+			template<typename... Args>
+			std::size_t grow_by(std::size_t n, Args const&... args) & noexcept {
+				auto const nBegin = m_nSize.fetch_add(n, std::memory_order_relaxed);
+				for_each_slot(nBegin, n, [&](T* p) noexcept {
+					::new(static_cast<void*>(p)) T(args...);
+				});
+				return nBegin;
+			}
+
+			// Appends the elements of rng and returns the index of the first one. Thread-safe.
+			template<tc::range_with_iterators Rng> requires tc::has_size<Rng>
+			std::size_t grow_by(Rng&& rng) & noexcept {
+				auto const n = tc::size(rng);
+				auto const nBegin = m_nSize.fetch_add(n, std::memory_order_relaxed);
+				auto it = tc::begin(rng);
+				for_each_slot(nBegin, n, [&](T* p) noexcept {
+					::new(static_cast<void*>(p)) T(*it);
+					++it;
+				});
+				return nBegin;
+			}
+
+			template<typename... Args>
+			T& emplace_back(Args&&... args) & noexcept {
+				auto const n = m_nSize.fetch_add(1, std::memory_order_relaxed);
+				auto const nSegment = concurrent_vector_detail::segment_of(n);
+				return *::new(static_cast<void*>(segment(nSegment) + (n - concurrent_vector_detail::segment_begin(nSegment)))) T(std::forward<Args>(args)...);
+			}
+
+			// Number of elements reserved by grow_by so far, including those other threads may still be constructing.
+			std::size_t size() const& noexcept {
+				return m_nSize.load(std::memory_order_acquire);
+			}
+			bool empty() const& noexcept {
+				return 0 == size();
+			}
+
+			T& operator[](std::size_t n) & noexcept {
+				_ASSERT( n < size() );
+				auto const nSegment = concurrent_vector_detail::segment_of(n);
+				return m_apSegment[nSegment].load(std::memory_order_acquire)[n - concurrent_vector_detail::segment_begin(nSegment)];
+			}
+			T const& operator[](std::size_t n) const& noexcept {
+				_ASSERT( n < size() );
+				auto const nSegment = concurrent_vector_detail::segment_of(n);
+				return m_apSegment[nSegment].load(std::memory_order_acquire)[n - concurrent_vector_detail::segment_begin(nSegment)];
+			}
+
+			// Generator range yielding one contiguous chunk per segment. Not thread-safe with respect to concurrent grow_by.
+			friend auto range_output_t_impl(concurrent_vector const&) -> tc::type::list<T const&>; // declaration only
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				auto const n = size();
+				using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<T const>>(), sink)), tc::constant<tc::continue_>>;
+				for( int nSegment = 0; nSegment < concurrent_vector_detail::c_nSegments; ++nSegment ) {
+					auto const nSegmentBegin = concurrent_vector_detail::segment_begin(nSegment);
+					if( n <= nSegmentBegin ) break;
+					T const* const p = m_apSegment[nSegment].load(std::memory_order_acquire);
+					tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(tc::counted(p, tc::min(n - nSegmentBegin, concurrent_vector_detail::segment_size(nSegment))), sink))) // MAYTHROW
+				}
+				return tc::implicit_cast<result_t>(tc::constant<tc::continue_>());
+			}
+		};
+
+		template<typename T>
+		struct concurrent_vector_appender final {
+			using guaranteed_break_or_continue = tc::constant<tc::continue_>;
+
+			concurrent_vector<T>& m_vec;
+
+			template<typename Rhs> requires std::is_constructible<T, Rhs&&>::value
+			void operator()(Rhs&& rhs) const& noexcept {
+				m_vec.emplace_back(std::forward<Rhs>(rhs));
+			}
+
+			// One atomic reservation per chunk.
+			template<tc::range_with_iterators Rng> requires tc::has_size<Rng> && std::is_constructible<T, decltype(*tc::begin(std::declval<Rng&>()))>::value
+			void chunk(Rng&& rng) const& noexcept {
+				m_vec.grow_by(std::forward<Rng>(rng));
+			}
+		};
+
+		template<typename T>
+		auto appender_impl(concurrent_vector<T>& vec) noexcept {
+			return concurrent_vector_appender<T>{vec};
+		}
+	}
+	using concurrent_vector_adl::concurrent_vector;
+}
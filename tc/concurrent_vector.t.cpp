@@ -0,0 +1,64 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "base/assert_defs.h"
+#include "unittest.h"
+#include "concurrent_vector.h"
+#include "algorithm/algorithm.h"
+#include "range/iota_range.h"
+
+#include <thread>
+
+static_assert(tc::appendable<tc::vector<int>, tc::concurrent_vector<int>&>);
+static_assert(tc::appendable<tc::vector<char const*>, tc::concurrent_vector<tc::string<char>>&>);
+static_assert(!tc::appendable<tc::vector<int>, tc::concurrent_vector<tc::string<char>>&>);
+
+UNITTESTDEF(concurrent_vector_single_thread) {
+	tc::concurrent_vector<tc::string<char>> vecstr;
+	_ASSERT( tc::empty(vecstr) );
+	_ASSERTEQUAL( vecstr.grow_by(2, "ab"), 0 );
+	auto& str = vecstr[1];
+	tc::append(vecstr, tc::vector<char const*>{"c", "d"});
+	for( int i = 0; i < 100; ++i ) vecstr.emplace_back("x");
+	_ASSERTEQUAL( &vecstr[1], &str ); // stable under growth
+	_ASSERTEQUAL( tc::size(vecstr), 104 );
+	_ASSERTEQUAL( vecstr[2], "c" );
+	_ASSERTEQUAL( vecstr[103], "x" );
+
+	auto const vec = tc::make_vector(vecstr);
+	_ASSERTEQUAL( tc::size(vec), 104 );
+	_ASSERTEQUAL( vec[0], "ab" );
+	_ASSERTEQUAL( vec[3], "d" );
+}
+
+UNITTESTDEF(concurrent_vector_parallel_append) {
+	tc::concurrent_vector<int> vecn;
+	constexpr int c_nThreads = 4;
+	constexpr int c_nChunks = 1000;
+	constexpr int c_nChunkSize = 7;
+	tc::vector<std::thread> vecthread;
+	for( int iThread = 0; iThread < c_nThreads; ++iThread ) {
+		tc::cont_emplace_back(vecthread, [&vecn, iThread]() noexcept {
+			for( int iChunk = 0; iChunk < c_nChunks; ++iChunk ) {
+				int const nFirst = (iThread * c_nChunks + iChunk) * c_nChunkSize;
+				tc::append(vecn, tc::iota(nFirst, nFirst + c_nChunkSize));
+			}
+		});
+	}
+	tc::for_each(vecthread, [](std::thread& thread) noexcept { thread.join(); });
+
+	auto vec = tc::make_vector(vecn);
+	_ASSERTEQUAL( tc::size(vec), c_nThreads * c_nChunks * c_nChunkSize );
+	// Chunks stay contiguous.
+	for( std::size_t i = 0; i < tc::size(vec); i += c_nChunkSize ) {
+		_ASSERTEQUAL( vec[i] % c_nChunkSize, 0 );
+		_ASSERTEQUAL( vec[i + c_nChunkSize - 1], vec[i] + c_nChunkSize - 1 );
+	}
+	tc::sort_inplace(vec);
+	_ASSERT( tc::equal(vec, tc::iota(0, c_nThreads * c_nChunks * c_nChunkSize)) );
+}
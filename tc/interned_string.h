@@ -0,0 +1,308 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "base/assert_defs.h"
+#include "base/noncopyable.h"
+#include "algorithm/append.h"
+#include "algorithm/empty.h"
+#include "algorithm/for_each.h"
+#include "algorithm/minmax.h"
+#include "algorithm/size.h"
+#include "container/container.h"
+#include "container/insert.h"
+#include "container/string.h"
+#include "range/subrange.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+namespace tc {
+	namespace interned_string_detail {
+		inline constexpr std::size_t c_nArenaBlockSize = 64 * 1024;
+
+		template<typename Char>
+		struct entry final {
+			std::size_t m_nHash;
+			std::size_t m_n;
+			Char const* m_pch; // null-terminated, stored right after the entry
+		};
+
+		// FNV-1a per character with a final mix, so that the low bits used as table index depend on all characters.
+		template<typename Char>
+		constexpr std::size_t hash(Char const* const pch, std::size_t const n) noexcept {
+			std::uint64_t nHash = 0xcbf29ce484222325;
+			for( std::size_t i = 0; i < n; ++i ) {
+				nHash = (nHash ^ static_cast<std::make_unsigned_t<Char>>(pch[i])) * 0x100000001b3;
+			}
+			nHash ^= nHash >> 33;
+			nHash *= 0xff51afd7ed558ccd;
+			nHash ^= nHash >> 33;
+			return static_cast<std::size_t>(nHash);
+		}
+
+		template<typename Char>
+		inline constexpr Char c_chEmpty = Char();
+
+		// The elements of RngRng are contiguous strings of Char living as long as rngrng, which can be hashed and looked up in place.
+		template<typename RngRng, typename Char>
+		concept contiguous_elements =
+			tc::range_with_iterators<RngRng const> &&
+			std::is_lvalue_reference<std::iter_reference_t<tc::iterator_t<RngRng const>>>::value &&
+			tc::contiguous_range<std::iter_reference_t<tc::iterator_t<RngRng const>>> &&
+			std::is_same<tc::range_value_t<std::iter_reference_t<tc::iterator_t<RngRng const>>>, Char>::value;
+
+		template<typename Char>
+		inline constexpr entry<Char> c_entryEmpty{hash(&c_chEmpty<Char>, 0), 0, &c_chEmpty<Char>};
+	}
+
+	namespace interned_string_adl {
+		template<typename Char>
+		struct interning_pool;
+
+		// Handle to a string in an interning_pool. Handles of equal strings from the same pool point to the same entry,
+		// so they compare and hash in O(1). As a range, a handle is the string, e.g., for ordered containers.
+		template<typename Char>
+		struct interned_string final {
+		private:
+			friend struct interning_pool<Char>;
+			interned_string_detail::entry<Char> const* m_pentry;
+
+			explicit interned_string(interned_string_detail::entry<Char> const* const pentry) noexcept : m_pentry(pentry) {}
+
+		public:
+			using value_type = Char;
+			using iterator = Char const*;
+			using const_iterator = Char const*;
+
+			// The empty string, equal to the empty string interned in any pool.
+			interned_string() noexcept : m_pentry(&interned_string_detail::c_entryEmpty<Char>) {}
+
+			Char const* begin() const& noexcept {
+				return m_pentry->m_pch;
+			}
+			Char const* end() const& noexcept {
+				return m_pentry->m_pch + m_pentry->m_n;
+			}
+			std::size_t size() const& noexcept {
+				return m_pentry->m_n;
+			}
+			bool empty() const& noexcept {
+				return 0 == m_pentry->m_n;
+			}
+			Char const* c_str() const& noexcept {
+				return m_pentry->m_pch;
+			}
+
+			// Precomputed when interning.
+			std::size_t hash() const& noexcept {
+				return m_pentry->m_nHash;
+			}
+
+			friend bool operator==(interned_string const& lhs, interned_string const& rhs) noexcept {
+				_ASSERT( (lhs.m_pentry == rhs.m_pentry) == (lhs.m_pentry->m_n == rhs.m_pentry->m_n && 0 == std::memcmp(lhs.m_pentry->m_pch, rhs.m_pentry->m_pch, lhs.m_pentry->m_n * sizeof(Char))) ); // handles from different pools?
+				return lhs.m_pentry == rhs.m_pentry;
+			}
+		};
+
+		// Thread-safe table of interned strings. The strings are stored in arena blocks, which are freed only with the pool,
+		// and found through an open-addressing hash table of their entries. Lookups of strings which are already interned only take
+		// a shared lock.
+		template<typename Char>
+		struct [[nodiscard]] interning_pool final : tc::nonmovable {
+		private:
+			using entry_t = interned_string_detail::entry<Char>;
+
+			mutable std::shared_mutex m_mtx;
+			tc::vector<entry_t const*> m_vecpentry = tc::vector<entry_t const*>(16, nullptr); // power of 2, at most half full
+			std::size_t m_nEntries = 0;
+			tc::vector<std::unique_ptr<std::byte[]>> m_vecpbyteBlock;
+			std::byte* m_pbyteFree = nullptr;
+			std::size_t m_nFree = 0;
+			std::size_t m_nArenaBytes = 0;
+
+			entry_t const* find(Char const* const pch, std::size_t const n, std::size_t const nHash) const& noexcept {
+				auto const nMask = m_vecpentry.size() - 1;
+				for( auto i = nHash & nMask; ; i = (i + 1) & nMask ) {
+					auto const pentry = m_vecpentry[i];
+					if( !pentry ) return nullptr;
+					if( pentry->m_nHash == nHash && pentry->m_n == n && 0 == std::memcmp(pentry->m_pch, pch, n * sizeof(Char)) ) return pentry;
+				}
+			}
+
+			void insert_slot(entry_t const* const pentryNew) & noexcept {
+				auto const nMask = m_vecpentry.size() - 1;
+				auto i = pentryNew->m_nHash & nMask;
+				while( m_vecpentry[i] ) i = (i + 1) & nMask;
+				m_vecpentry[i] = pentryNew;
+			}
+
+			void* allocate(std::size_t nBytes) & noexcept {
+				nBytes = (nBytes + alignof(entry_t) - 1) / alignof(entry_t) * alignof(entry_t);
+				if( m_nFree < nBytes ) {
+					auto const nBlock = tc::max(interned_string_detail::c_nArenaBlockSize, nBytes);
+					tc::cont_emplace_back(m_vecpbyteBlock, std::make_unique_for_overwrite<std::byte[]>(nBlock));
+					m_pbyteFree = tc::back(m_vecpbyteBlock).get();
+					m_nFree = nBlock;
+					m_nArenaBytes += nBlock;
+				}
+				auto const pv = m_pbyteFree;
+				m_pbyteFree += nBytes;
+				m_nFree -= nBytes;
+				return pv;
+			}
+
+			// Requires the exclusive lock.
+			entry_t const* find_or_insert(Char const* const pch, std::size_t const n, std::size_t const nHash) & noexcept {
+				if( auto const pentry = find(pch, n, nHash) ) return pentry;
+				auto const pv = allocate(sizeof(entry_t) + (n + 1) * sizeof(Char));
+				auto const pchCopy = reinterpret_cast<Char*>(static_cast<std::byte*>(pv) + sizeof(entry_t));
+				std::memcpy(pchCopy, pch, n * sizeof(Char));
+				pchCopy[n] = Char();
+				auto const pentryNew = ::new(pv) entry_t{nHash, n, pchCopy};
+
+				if( m_vecpentry.size() < 2 * (m_nEntries + 1) ) {
+					tc::vector<entry_t const*> vecpentry(2 * m_vecpentry.size(), nullptr);
+					swap(vecpentry, m_vecpentry);
+					for( auto const pentry : vecpentry ) {
+						if( pentry ) insert_slot(pentry);
+					}
+				}
+				insert_slot(pentryNew);
+				++m_nEntries;
+				return pentryNew;
+			}
+
+			template<typename Rng, typename Func>
+			static decltype(auto) with_contiguous(Rng const& rng, Func func) noexcept {
+				if constexpr( tc::contiguous_range<Rng const&> && std::is_same<tc::range_value_t<Rng const&>, Char>::value ) {
+					return func(tc::ptr_begin(rng), tc::size(rng));
+				} else {
+					auto const str = tc::make_str<Char>(rng);
+					return func(tc::ptr_begin(str), tc::size(str));
+				}
+			}
+
+		public:
+			interning_pool() noexcept = default;
+
+			template<typename Rng>
+			interned_string<Char> intern(Rng const& rng) & noexcept {
+				return with_contiguous(rng, [&](Char const* const pch, std::size_t const n) noexcept {
+					if( 0 == n ) return interned_string<Char>();
+					auto const nHash = interned_string_detail::hash(pch, n);
+					{
+						std::shared_lock<std::shared_mutex> lock(m_mtx);
+						if( auto const pentry = find(pch, n, nHash) ) return interned_string<Char>(pentry);
+					}
+					std::scoped_lock<std::shared_mutex> lock(m_mtx);
+					return interned_string<Char>(find_or_insert(pch, n, nHash));
+				});
+			}
+
+			// Interns all strings of rngrng, in order. Hashes are computed before locking, and the pool is locked once
+			// for lookups and at most once for inserting the new strings. Only strings which are not contiguous ranges of Char
+			// in rngrng are copied.
+			template<typename RngRng>
+			tc::vector<interned_string<Char>> intern_all(RngRng const& rngrng) & noexcept {
+				struct pending final {
+					Char const* m_pch;
+					std::size_t m_n;
+					std::size_t m_nHash;
+				};
+				tc::vector<pending> vecpending;
+				tc::vector<tc::string<Char>> vecstr;
+				if constexpr( interned_string_detail::contiguous_elements<RngRng, Char> ) {
+					for( auto const& rng : rngrng ) {
+						auto const pch = tc::ptr_begin(rng);
+						auto const n = tc::size(rng);
+						tc::cont_emplace_back(vecpending, pending{pch, n, interned_string_detail::hash(pch, n)});
+					}
+				} else {
+					tc::for_each(rngrng, [&](auto const& rng) noexcept {
+						tc::cont_emplace_back(vecstr, tc::make_str<Char>(rng));
+					});
+					// The characters of vecstr only stay in place once it is complete.
+					for( auto const& str : vecstr ) {
+						auto const pch = tc::ptr_begin(str);
+						auto const n = tc::size(str);
+						tc::cont_emplace_back(vecpending, pending{pch, n, interned_string_detail::hash(pch, n)});
+					}
+				}
+
+				tc::vector<interned_string<Char>> vecistr(tc::size(vecpending));
+				bool bMissing = false;
+				{
+					std::shared_lock<std::shared_mutex> lock(m_mtx);
+					for( std::size_t i = 0; i < tc::size(vecpending); ++i ) {
+						auto const& pending = vecpending[i];
+						if( 0 == pending.m_n ) continue;
+						if( auto const pentry = find(pending.m_pch, pending.m_n, pending.m_nHash) ) {
+							vecistr[i] = interned_string<Char>(pentry);
+						} else {
+							bMissing = true;
+						}
+					}
+				}
+				if( bMissing ) {
+					std::scoped_lock<std::shared_mutex> lock(m_mtx);
+					for( std::size_t i = 0; i < tc::size(vecpending); ++i ) {
+						auto const& pending = vecpending[i];
+						if( 0 != pending.m_n && vecistr[i].empty() ) {
+							vecistr[i] = interned_string<Char>(find_or_insert(pending.m_pch, pending.m_n, pending.m_nHash));
+						}
+					}
+				}
+				return vecistr;
+			}
+
+			// Number of distinct non-empty strings.
+			std::size_t size() const& noexcept {
+				std::shared_lock<std::shared_mutex> lock(m_mtx);
+				return m_nEntries;
+			}
+
+			std::size_t arena_bytes() const& noexcept {
+				std::shared_lock<std::shared_mutex> lock(m_mtx);
+				return m_nArenaBytes;
+			}
+
+			// Pool used by tc::intern, alive until the end of the program.
+			static interning_pool& global() noexcept {
+				static interning_pool s_pool;
+				return s_pool;
+			}
+		};
+	}
+	using interned_string_adl::interned_string;
+	using interned_string_adl::interning_pool;
+
+	template<typename Rng>
+	auto intern(Rng const& rng) noexcept {
+		return tc::interning_pool<tc::range_value_t<Rng const&>>::global().intern(rng);
+	}
+
+	template<typename RngRng>
+	auto intern_all(RngRng const& rngrng) noexcept {
+		return tc::interning_pool<tc::range_value_t<tc::range_value_t<RngRng const&>>>::global().intern_all(rngrng);
+	}
+}
+
+namespace std {
+	template<typename Char>
+	struct hash<tc::interned_string<Char>> {
+		std::size_t operator()(tc::interned_string<Char> const& istr) const& noexcept {
+			return istr.hash();
+		}
+	};
+}
@@ -0,0 +1,95 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "base/assert_defs.h"
+#include "unittest.h"
+#include "interned_string.h"
+#include "algorithm/algorithm.h"
+#include "range/transform.h"
+#include "string/format.h"
+
+#include <thread>
+#include <unordered_map>
+
+UNITTESTDEF(interned_string_identity) {
+	tc::interning_pool<char> pool;
+	auto const istrA = pool.intern("identifier");
+	auto const istrB = pool.intern(tc::string<char>("identifier"));
+	auto const istrC = pool.intern(tc::transform(tc::string<char>("IDENTIFIER"), [](char const ch) noexcept { return static_cast<char>(ch - 'A' + 'a'); }));
+	_ASSERT( istrA == istrB );
+	_ASSERT( istrA == istrC );
+	_ASSERTEQUAL( istrA.begin(), istrB.begin() );
+	_ASSERTEQUAL( istrA.hash(), istrB.hash() );
+	_ASSERT( istrA != pool.intern("identifie") );
+	_ASSERT( tc::equal(istrA, "identifier") );
+	_ASSERTEQUAL( tc::size(istrA), 10 );
+	_ASSERTEQUAL( std::strlen(istrA.c_str()), 10 );
+	_ASSERTEQUAL( pool.size(), 2 );
+
+	_ASSERT( pool.intern("") == tc::interned_string<char>() );
+	_ASSERT( tc::empty(tc::interned_string<char>()) );
+	_ASSERTEQUAL( pool.size(), 2 );
+
+	std::unordered_map<tc::interned_string<char>, int> map;
+	map[istrA] = 1;
+	_ASSERTEQUAL( map[istrC], 1 );
+	// ordering compares the characters
+	_ASSERT( std::is_lt(tc::lexicographical_compare_3way(pool.intern("a"), pool.intern("b"))) );
+}
+
+UNITTESTDEF(interned_string_bulk) {
+	tc::interning_pool<char> pool;
+	tc::vector<tc::string<char>> vecstr;
+	for( int i = 0; i < 10000; ++i ) tc::cont_emplace_back(vecstr, tc::make_str<char>("name", tc::as_dec(i % 1000)));
+	tc::cont_emplace_back(vecstr, tc::string<char>());
+	auto const vecistr = pool.intern_all(vecstr);
+	_ASSERTEQUAL( tc::size(vecistr), tc::size(vecstr) );
+	_ASSERTEQUAL( pool.size(), 1000 );
+	for( std::size_t i = 0; i < tc::size(vecstr); ++i ) {
+		_ASSERT( tc::equal(vecistr[i], vecstr[i]) );
+		_ASSERT( vecistr[i] == pool.intern(vecstr[i]) );
+	}
+	_ASSERT( vecistr[3] == vecistr[1003] );
+	_ASSERTEQUAL( pool.arena_bytes(), tc::interned_string_detail::c_nArenaBlockSize ); // 1000 short strings fit into one block
+
+	// Strings which are not contiguous are copied before interning.
+	static_assert( tc::interned_string_detail::contiguous_elements<tc::vector<tc::string<char>>, char> );
+	auto const Upper = [](auto const& str) noexcept { return tc::transform(str, [](char const ch) noexcept { return tc::toasciiupper(ch); }); };
+	auto const rngstrUpper = tc::transform(vecstr, Upper);
+	static_assert( !tc::interned_string_detail::contiguous_elements<decltype(rngstrUpper), char> );
+	auto const vecistrUpper = pool.intern_all(rngstrUpper);
+	_ASSERTEQUAL( tc::size(vecistrUpper), tc::size(vecstr) );
+	_ASSERTEQUAL( pool.size(), 2000 );
+	for( std::size_t i = 0; i < tc::size(vecstr); ++i ) {
+		_ASSERT( vecistrUpper[i] == pool.intern(Upper(vecstr[i])) );
+	}
+}
+
+UNITTESTDEF(interned_string_threads) {
+	tc::interning_pool<char> pool;
+	tc::vector<tc::vector<tc::interned_string<char>>> vecvecistr(4);
+	{
+		tc::vector<std::thread> vecthread;
+		for( std::size_t nThread = 0; nThread < 4; ++nThread ) {
+			tc::cont_emplace_back(vecthread, [&, nThread]() noexcept {
+				for( int i = 0; i < 5000; ++i ) {
+					tc::cont_emplace_back(vecvecistr[nThread], pool.intern(tc::make_str<char>("s", tc::as_dec((i * 7 + nThread) % 3000))));
+				}
+			});
+		}
+		for( auto& thread : vecthread ) thread.join();
+	}
+	_ASSERTEQUAL( pool.size(), 3000 );
+	for( std::size_t nThread = 0; nThread < 4; ++nThread ) {
+		for( int i = 0; i < 5000; ++i ) {
+			_ASSERT( vecvecistr[nThread][i] == pool.intern(tc::make_str<char>("s", tc::as_dec((i * 7 + nThread) % 3000))) );
+		}
+	}
+
+	_ASSERT( tc::intern("global") == tc::intern(tc::string<char>("global")) );
+}
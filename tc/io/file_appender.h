@@ -0,0 +1,220 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/noncopyable.h"
+#include "../base/bit_cast.h"
+#include "../range/subrange.h"
+#include "../algorithm/for_each.h"
+#include "../algorithm/append.h"
+#include "../string/convert_enc.h"
+#include "file_failure.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <new>
+
+namespace tc {
+	namespace file_appender_detail {
+		// Alignment of the buffer, sufficient for unbuffered I/O on all relevant file systems.
+		inline constexpr std::size_t c_nBufferAlignment = 4096;
+
+		struct aligned_delete final {
+			void operator()(unsigned char* pb) const& noexcept {
+				::operator delete[](pb, std::align_val_t(c_nBufferAlignment));
+			}
+		};
+
+		// Writes rngbFirst followed by rngbSecond, retrying on partial writes and interrupts.
+		inline void write_all(int fd, tc::span<unsigned char const> rngbFirst, tc::span<unsigned char const> rngbSecond) THROW(tc::file_failure) {
+#ifdef _WIN32
+			// No writev on Windows, the CRT buffers internally anyway.
+			for( auto rngb : {rngbFirst, rngbSecond} ) {
+				auto pb = tc::ptr_begin(rngb);
+				auto const pbEnd = tc::ptr_end(rngb);
+				while( pb != pbEnd ) {
+					auto const nWritten = ::_write(fd, pb, tc::explicit_cast<unsigned int>(tc::min(pbEnd - pb, INT_MAX)));
+					if( nWritten < 0 ) throw tc::file_failure();
+					pb += nWritten;
+				}
+			}
+#else
+			// writev lets the kernel gather the buffered bytes and a large chunk in one call without copying the chunk.
+			::iovec aiov[2] = {
+				{const_cast<unsigned char*>(tc::ptr_begin(rngbFirst)), tc::size(rngbFirst)},
+				{const_cast<unsigned char*>(tc::ptr_begin(rngbSecond)), tc::size(rngbSecond)}
+			};
+			::iovec* piov = aiov;
+			int niov = 2;
+			while( 0 < niov ) {
+				if( 0 == piov->iov_len ) {
+					++piov;
+					--niov;
+					continue;
+				}
+				auto nWritten = ::writev(fd, piov, niov);
+				if( nWritten < 0 ) {
+					if( EINTR == errno ) continue;
+					throw tc::file_failure();
+				}
+				while( 0 < niov && piov->iov_len <= tc::as_unsigned(nWritten) ) {
+					nWritten -= piov->iov_len;
+					++piov;
+					--niov;
+				}
+				if( 0 < niov ) {
+					piov->iov_base = static_cast<unsigned char*>(piov->iov_base) + nWritten;
+					piov->iov_len -= nWritten;
+				}
+			}
+#endif
+		}
+
+		template<typename T>
+		concept byte_like = std::same_as<std::remove_cv_t<T>, unsigned char> || std::same_as<std::remove_cv_t<T>, tc::char_ascii> || std::same_as<std::remove_cv_t<T>, char>;
+	}
+
+	namespace file_appender_adl {
+		// Buffered sink writing to a file descriptor, usable as target of tc::append. The file descriptor is not owned.
+		// Chars and bytes are collected in an aligned buffer of fixed size. Contiguous chunks at least as large as the
+		// buffer bypass it: they are written together with the buffered bytes by a single writev without being copied.
+		// Other char types are converted to UTF-8.
+		// The destructor flushes, but ignores errors. Call flush() to observe them.
+		struct [[nodiscard]] fd_appender : tc::nonmovable {
+			static constexpr std::size_t c_nDefaultBufferSize = 64 * 1024;
+
+			explicit fd_appender(int fd, std::size_t nBufferSize = c_nDefaultBufferSize) noexcept
+				: m_fd(fd)
+				, m_pbBuffer(static_cast<unsigned char*>(::operator new[](nBufferSize, std::align_val_t(file_appender_detail::c_nBufferAlignment))))
+				, m_nBufferSize(nBufferSize)
+			{
+				_ASSERT( 0 < nBufferSize );
+			}
+
+			~fd_appender() {
+				try {
+					flush();
+				} catch( tc::file_failure const& ) {
+				}
+			}
+
+			void flush() & THROW(tc::file_failure) {
+				auto const nBuffered = m_nBuffered;
+				m_nBuffered = 0;
+				file_appender_detail::write_all(m_fd, tc::counted(tc::implicit_cast<unsigned char const*>(m_pbBuffer.get()), nBuffered), tc::make_empty_range<unsigned char const>()); // THROW(tc::file_failure)
+			}
+
+			void write_byte(unsigned char b) & THROW(tc::file_failure) {
+				if( m_nBuffered == m_nBufferSize ) flush(); // THROW(tc::file_failure)
+				m_pbBuffer[m_nBuffered] = b;
+				++m_nBuffered;
+			}
+
+			void write(tc::span<unsigned char const> rngb) & THROW(tc::file_failure) {
+				if( tc::size(rngb) <= m_nBufferSize - m_nBuffered ) {
+					std::memcpy(m_pbBuffer.get() + m_nBuffered, tc::ptr_begin(rngb), tc::size(rngb));
+					m_nBuffered += tc::size(rngb);
+				} else if( tc::size(rngb) < m_nBufferSize ) {
+					flush(); // THROW(tc::file_failure)
+					std::memcpy(m_pbBuffer.get(), tc::ptr_begin(rngb), tc::size(rngb));
+					m_nBuffered = tc::size(rngb);
+				} else {
+					auto const nBuffered = m_nBuffered;
+					m_nBuffered = 0;
+					file_appender_detail::write_all(m_fd, tc::counted(tc::implicit_cast<unsigned char const*>(m_pbBuffer.get()), nBuffered), rngb); // THROW(tc::file_failure)
+				}
+			}
+
+			int fd() const& noexcept {
+				return m_fd;
+			}
+
+		protected:
+			int m_fd;
+
+		private:
+			std::unique_ptr<unsigned char[], file_appender_detail::aligned_delete> m_pbBuffer;
+			std::size_t m_nBufferSize;
+			std::size_t m_nBuffered = 0;
+		};
+
+		// fd_appender owning a file opened for writing. An existing file is truncated.
+		struct [[nodiscard]] file_appender final : fd_appender {
+			explicit file_appender(std::filesystem::path const& path, std::size_t nBufferSize = c_nDefaultBufferSize) THROW(tc::file_failure)
+				: fd_appender(open(path), nBufferSize)
+			{}
+
+			~file_appender() {
+				try {
+					flush();
+				} catch( tc::file_failure const& ) {
+				}
+#ifdef _WIN32
+				::_close(m_fd);
+#else
+				::close(m_fd);
+#endif
+			}
+
+		private:
+			static int open(std::filesystem::path const& path) THROW(tc::file_failure) {
+#ifdef _WIN32
+				int const fd = ::_wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+				int fd;
+				do {
+					fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+				} while( fd < 0 && EINTR == errno );
+#endif
+				if( fd < 0 ) throw tc::file_failure();
+				return fd;
+			}
+		};
+
+		struct fd_appender_sink final {
+			using guaranteed_break_or_continue = tc::constant<tc::continue_>;
+
+			fd_appender& m_appdr;
+
+			template<file_appender_detail::byte_like T>
+			void operator()(T const& t) const& THROW(tc::file_failure) {
+				m_appdr.write_byte(tc::bit_cast<unsigned char>(t)); // THROW(tc::file_failure)
+			}
+
+			template<tc::contiguous_range Rng> requires file_appender_detail::byte_like<std::remove_pointer_t<decltype(tc::ptr_begin(std::declval<Rng&>()))>>
+			void chunk(Rng&& rng) const& THROW(tc::file_failure) {
+				m_appdr.write(tc::range_as_blob(rng)); // THROW(tc::file_failure)
+			}
+
+			template<tc::range_with_iterators Rng> requires tc::char_type<tc::range_value_t<Rng>> && (!std::same_as<tc::range_value_t<Rng>, char>)
+			void chunk(Rng&& rng) const& THROW(tc::file_failure) {
+				tc::for_each(tc::convert_enc<char>(std::forward<Rng>(rng)), *this); // THROW(tc::file_failure)
+			}
+		};
+
+		inline auto appender_impl(fd_appender& appdr) noexcept {
+			return fd_appender_sink{appdr};
+		}
+	}
+	using file_appender_adl::fd_appender;
+	using file_appender_adl::file_appender;
+}
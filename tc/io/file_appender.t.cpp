@@ -0,0 +1,46 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../string/format.h"
+#include "../range/repeat_n.h"
+#include "file_appender.h"
+#include "mapped_file.h"
+
+static_assert(tc::appendable<char const*, tc::fd_appender&>);
+static_assert(tc::appendable<tc::char16 const*, tc::fd_appender&>);
+static_assert(tc::appendable<decltype(tc::as_dec(5)), tc::file_appender&>);
+static_assert(tc::appendable<decltype(tc::size_prefixed(std::declval<tc::string<char>&>())), tc::file_appender&>);
+static_assert(!tc::appendable<tc::vector<int>, tc::file_appender&>);
+
+UNITTESTDEF(file_appender) {
+	auto const path = std::filesystem::temp_directory_path() / "tc_file_appender.bin";
+	auto const str = tc::make_str(tc::repeat_n(100, 'x'));
+	{
+		tc::file_appender file(path, /*nBufferSize*/16);
+		tc::append(file, "abc", tc::as_dec(42), u"ä"); // buffered
+		tc::append(file, str); // bypasses buffer
+		tc::append(file, tc::size_prefixed(tc::as_lvalue(tc::make_str("de")))); // blob chunks
+		file.flush();
+	}
+	{
+		tc::mapped_file<char const> file(path);
+		_ASSERTEQUAL( tc::size(file), 3 + 2 + 2 + 100 + 4 + 2 );
+		_ASSERT( tc::equal(tc::begin_next<tc::return_take>(file, 7), "abc42\xc3\xa4") );
+		_ASSERT( tc::equal(tc::slice(file, tc::begin(file) + 7, tc::begin(file) + 107), str) );
+		_ASSERT( tc::equal(tc::range_as_blob(tc::begin_next<tc::return_drop>(file, 107)), tc::concat(tc::as_blob(std::uint32_t(2)), tc::range_as_blob("de"))) );
+	}
+	std::filesystem::remove(path);
+
+	try {
+		tc::file_appender file(std::filesystem::temp_directory_path() / "tc_file_appender_no_such_dir" / "file.txt");
+		_ASSERTFALSE;
+	} catch( tc::file_failure const& ) {
+	}
+}
@@ -0,0 +1,15 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+namespace tc {
+	// Thrown by file sources and sinks if the operating system reports an error.
+	// Generators writing into file sinks document this with // THROW(tc::file_failure).
+	struct file_failure final {};
+}
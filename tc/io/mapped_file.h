@@ -0,0 +1,179 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/noncopyable.h"
+#include "../base/enum.h"
+#include "../base/bit_cast.h"
+#include "../range/subrange.h"
+#include "../algorithm/for_each.h"
+#include "file_failure.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace tc {
+	TC_DEFINE_ENUM(EMappedFileAdvice, emfadvice, (NORMAL)(SEQUENTIAL)(RANDOM)(WILLNEED))
+
+	namespace mapped_file_detail {
+		inline boost::interprocess::mapped_region::advice_types as_advice_type(tc::EMappedFileAdvice emfadvice) noexcept {
+			switch_no_default(emfadvice) {
+				case tc::emfadviceNORMAL: return boost::interprocess::mapped_region::advice_normal;
+				case tc::emfadviceSEQUENTIAL: return boost::interprocess::mapped_region::advice_sequential;
+				case tc::emfadviceRANDOM: return boost::interprocess::mapped_region::advice_random;
+				case tc::emfadviceWILLNEED: return boost::interprocess::mapped_region::advice_willneed;
+			}
+		}
+	}
+
+	namespace mapped_file_adl {
+		// Memory-mapped file which models a contiguous range of T, so tc::ptr_begin, tc::as_span and all algorithms work on it directly.
+		// T const maps read-only, T maps read-write. Writes to a read-write mapping go directly to the file.
+		// A mapped_file of an empty file is an empty range without a mapping.
+		template<typename T>
+		struct [[nodiscard]] mapped_file final : tc::noncopyable {
+			static_assert( std::is_trivially_copyable<T>::value );
+			static_assert( tc::decayed<std::remove_const_t<T>> );
+
+		private:
+			static constexpr auto c_mode = std::is_const<T>::value ? boost::interprocess::read_only : boost::interprocess::read_write;
+
+			boost::interprocess::mapped_region m_region;
+			std::size_t m_n = 0;
+
+			void map(std::filesystem::path const& path, tc::EMappedFileAdvice emfadvice, bool bHugePages) THROW(tc::file_failure) {
+				try {
+					auto const nBytes = std::filesystem::file_size(path); // THROW(std::filesystem::filesystem_error)
+					if( 0 == nBytes ) return; // cannot map zero bytes
+					if( 0 != nBytes % sizeof(T) ) throw tc::file_failure(); // truncated or not a file of T
+					boost::interprocess::mapped_region region(boost::interprocess::file_mapping(path.c_str(), c_mode), c_mode); // THROW(boost::interprocess::interprocess_exception)
+					m_n = tc::explicit_cast<std::size_t>(nBytes / sizeof(T));
+					region.advise(mapped_file_detail::as_advice_type(emfadvice)); // only a hint, ignore failure
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+					if( bHugePages ) {
+						// Only honored by file systems supporting transparent huge pages for page cache, ignore failure.
+						::madvise(region.get_address(), region.get_size(), MADV_HUGEPAGE);
+					}
+#else
+					tc::discard(bHugePages);
+#endif
+					m_region.swap(region);
+				} catch( boost::interprocess::interprocess_exception const& ) {
+					throw tc::file_failure();
+				} catch( std::filesystem::filesystem_error const& ) {
+					throw tc::file_failure();
+				}
+			}
+
+		public:
+			using value_type = std::remove_const_t<T>;
+			using iterator = T*;
+			using const_iterator = T*; // the mapping is not owned data, like tc::span
+			using size_type = std::size_t;
+			using difference_type = std::ptrdiff_t;
+
+			explicit mapped_file(std::filesystem::path const& path, tc::EMappedFileAdvice emfadvice = tc::emfadviceSEQUENTIAL, bool bHugePages = false) THROW(tc::file_failure) {
+				map(path, emfadvice, bHugePages);
+			}
+
+			// Creates the file if necessary and resizes it to n elements before mapping it read-write.
+			explicit mapped_file(std::filesystem::path const& path, std::size_t n, tc::EMappedFileAdvice emfadvice = tc::emfadviceSEQUENTIAL, bool bHugePages = false) THROW(tc::file_failure)
+				requires (!std::is_const<T>::value)
+			{
+				try {
+					if( !std::filesystem::exists(path) ) {
+						if( !std::ofstream(path, std::ios_base::binary) ) throw tc::file_failure();
+					}
+					std::filesystem::resize_file(path, n * sizeof(T)); // THROW(std::filesystem::filesystem_error)
+				} catch( std::filesystem::filesystem_error const& ) {
+					throw tc::file_failure();
+				}
+				map(path, emfadvice, bHugePages);
+			}
+
+			mapped_file(mapped_file&& other) noexcept
+				: m_n(tc_move_always(other.m_n))
+			{
+				m_region.swap(other.m_region);
+				other.m_n = 0;
+			}
+
+			mapped_file& operator=(mapped_file&& other) & noexcept {
+				m_region.swap(other.m_region);
+				tc::swap(m_n, other.m_n);
+				return *this;
+			}
+
+			[[nodiscard]] T* data() const& noexcept {
+				return static_cast<T*>(m_region.get_address());
+			}
+			[[nodiscard]] T* begin() const& noexcept {
+				return data();
+			}
+			[[nodiscard]] T* end() const& noexcept {
+				return data() + m_n;
+			}
+			[[nodiscard]] std::size_t size() const& noexcept {
+				return m_n;
+			}
+
+			// Writes modified pages back to the file. Only needed if the data must reach the disk before the mapping is closed.
+			void flush() & THROW(tc::file_failure) requires (!std::is_const<T>::value) {
+				if( 0 < m_n && !m_region.flush() ) throw tc::file_failure();
+			}
+		};
+	}
+	using mapped_file_adl::mapped_file;
+
+	namespace split_records_detail {
+		template<typename T>
+		T const* find_delimiter(T const* pBegin, T const* pEnd, T const& tDelimiter) noexcept {
+			if constexpr( 1 == sizeof(T) && std::is_integral<T>::value ) {
+				// memchr is vectorized by all relevant C runtimes.
+				if( auto const p = std::memchr(pBegin, tc::bit_cast<unsigned char>(tDelimiter), tc::explicit_cast<std::size_t>(pEnd - pBegin)) ) {
+					return static_cast<T const*>(p);
+				} else {
+					return pEnd;
+				}
+			} else {
+				return std::find(pBegin, pEnd, tDelimiter);
+			}
+		}
+	}
+
+	// Splits a contiguous range at each occurrence of tDelimiter and yields the records in between as spans pointing into rng.
+	// A trailing delimiter does not start an empty record. The delimiters are not part of the records.
+	template<tc::contiguous_range Rng>
+	auto split_records(Rng&& rng, tc::range_value_t<Rng> tDelimiter) noexcept {
+		auto rngref = tc::make_reference_or_value(std::forward<Rng>(rng));
+		using value_type = std::remove_pointer_t<decltype(tc::ptr_begin(*tc::as_const(rngref)))>;
+		return tc::generator_range_output<tc::span<value_type>>([rng = tc_move(rngref), tDelimiter](auto&& sink) MAYTHROW
+			-> tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<tc::span<value_type>>())), tc::constant<tc::continue_>>
+		{
+			auto p = tc::ptr_begin(*rng);
+			auto const pEnd = tc::ptr_end(*rng);
+			while( p != pEnd ) {
+				auto const pDelimiter = p + (split_records_detail::find_delimiter<std::remove_const_t<value_type>>(p, pEnd, tDelimiter) - p);
+				tc_yield(sink, tc::make_iterator_range(p, pDelimiter)); // MAYTHROW
+				if( pDelimiter == pEnd ) break;
+				p = pDelimiter + 1;
+			}
+			return tc::constant<tc::continue_>();
+		});
+	}
+}
@@ -0,0 +1,91 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../algorithm/equal.h"
+#include "mapped_file.h"
+
+namespace {
+	std::filesystem::path write_temp_file(char const* szName, char const* szContent) noexcept {
+		auto path = std::filesystem::temp_directory_path() / szName;
+		std::ofstream(path, std::ios_base::binary | std::ios_base::trunc) << szContent;
+		return path;
+	}
+}
+
+UNITTESTDEF(mapped_file_read_only) {
+	auto const path = write_temp_file("tc_mapped_file_read_only.txt", "alpha\nbeta\n\ngamma");
+	{
+		tc::mapped_file<char const> file(path);
+		static_assert( tc::contiguous_range<decltype(file)&> );
+		_ASSERTEQUAL( tc::size(file), 17 );
+		_ASSERT( tc::equal(file, "alpha\nbeta\n\ngamma") );
+		_ASSERT( tc::equal(tc::as_span(file), "alpha\nbeta\n\ngamma") );
+
+		tc::vector<tc::string<char>> vecstr;
+		tc::for_each(tc::split_records(file, '\n'), [&](auto const& rng) noexcept {
+			static_assert( std::is_same<decltype(tc::ptr_begin(rng)), char const*>::value );
+			_ASSERT( tc::ptr_begin(file) <= tc::ptr_begin(rng) && tc::ptr_end(rng) <= tc::ptr_end(file) );
+			tc::cont_emplace_back(vecstr, tc::make_str(rng));
+		});
+		_ASSERT( tc::equal((tc::vector<tc::string<char>>{"alpha", "beta", "", "gamma"}), vecstr) );
+
+		auto fileMoved = tc_move(file);
+		_ASSERTEQUAL( tc::size(file), 0 );
+		_ASSERTEQUAL( tc::size(fileMoved), 17 );
+	}
+	std::filesystem::remove(path);
+
+	auto const pathEmpty = write_temp_file("tc_mapped_file_empty.txt", "");
+	{
+		tc::mapped_file<unsigned char const> file(pathEmpty, tc::emfadviceRANDOM);
+		_ASSERT( tc::empty(file) );
+		_ASSERT( tc::empty(tc::split_records(file, '\n')) );
+	}
+	std::filesystem::remove(pathEmpty);
+
+	try {
+		tc::mapped_file<char const> file(std::filesystem::temp_directory_path() / "tc_mapped_file_does_not_exist.txt");
+		_ASSERTFALSE;
+	} catch( tc::file_failure const& ) {
+	}
+
+	auto const pathTruncated = write_temp_file("tc_mapped_file_truncated.bin", "12345");
+	try {
+		tc::mapped_file<std::uint32_t const> file(pathTruncated);
+		_ASSERTFALSE;
+	} catch( tc::file_failure const& ) {
+	}
+	std::filesystem::remove(pathTruncated);
+}
+
+UNITTESTDEF(mapped_file_read_write) {
+	auto const path = std::filesystem::temp_directory_path() / "tc_mapped_file_read_write.bin";
+	std::filesystem::remove(path);
+	{
+		tc::mapped_file<char> file(path, 5);
+		_ASSERTEQUAL( tc::size(file), 5 );
+		for( char& ch : file ) ch = 'x';
+		tc::at(file, 2) = ';';
+		file.flush();
+	}
+	{
+		tc::mapped_file<char const> file(path);
+		_ASSERT( tc::equal(file, "xx;xx") );
+		_ASSERT( tc::equal((tc::vector<tc::string<char>>{"xx", "xx"}), tc::make_vector(tc::transform(tc::split_records(file, ';'), tc_fn(tc::make_str)))) );
+	}
+	std::filesystem::remove(path);
+}
+
+UNITTESTDEF(split_records_string) {
+	tc::vector<int> vecn{1, 0, 2, 3, 0, 0};
+	_ASSERT( tc::equal((tc::vector<tc::vector<int>>{{1}, {2, 3}, {}}), tc::make_vector(tc::transform(tc::split_records(vecn, 0), tc_fn(tc::make_vector)))) );
+	_ASSERTEQUAL( tc::size(tc::make_vector(tc::split_records(tc::string<char>(";;"), ';'))), 2 );
+}
@@ -0,0 +1,266 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/explicit_cast.h"
+#include "../base/reference_or_value.h"
+#include "../base/tag_type.h"
+#include "../base/type_list.h"
+#include "../algorithm/for_each.h"
+#include "../container/cont_reserve.h"
+#include "../container/insert.h"
+#include "../range/subrange.h"
+#include "../array.h"
+#include "../optional.h"
+#include "../tuple.h"
+
+#include <boost/container/container_fwd.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <variant>
+
+// Binary serialization of values into byte generators, and deserialization from contiguous byte buffers.
+//
+// The wire format is the in-memory representation of arithmetic types and enums, like tc::as_blob,
+// so it is not portable between platforms of different endianness. On top of that:
+//	- bool is one byte, 0 or 1.
+//	- std::optional and tc::optional are a bool followed by the value if present, like tc::bool_prefixed.
+//	- std::variant is the LEB128-encoded index followed by the active alternative.
+//	- tc::tuple and std::pair are their elements in order.
+//	- tc::dense_map and types derived from it, e.g., tc::interval, are their values in key order. The number of keys is fixed, so there is no size.
+//	- Other ranges are their LEB128-encoded size followed by their elements. Contiguous ranges of arithmetic types and enums
+//	  are written and read by a single memcpy.
+// Types may customize serialization by providing serialize_impl(T const&) returning a generator of unsigned char const&
+// and deserialize_impl(tc::type::identity<T>, tc::span<unsigned char const>&) found by ADL.
+
+namespace tc {
+	// Thrown by tc::deserialize if the input is truncated or does not encode a value of the requested type.
+	struct deserialize_failure final {};
+
+	namespace serialize_detail {
+		template<typename T>
+		concept blob_element = (std::is_arithmetic<T>::value || std::is_enum<T>::value) && !std::same_as<T, bool>;
+
+		template<typename T>
+		concept optional_like = tc::instance<T, std::optional> || tc::instance<T, tc::optional>;
+
+		template<typename T>
+		concept tuple_like = tc::instance<T, tc::tuple> || tc::instance<T, std::pair>;
+
+		template<typename T>
+		concept dense_map_like = requires { typename T::dense_map_key_type; };
+
+		// tc::span of const bytes, which deserialization can point into the input instead of copying.
+		template<typename T>
+		concept borrowed_span = tc::contiguous_range<T> && requires { typename T::iterator; }
+			&& std::same_as<T, tc::span<std::remove_pointer_t<decltype(tc::ptr_begin(std::declval<T&>()))>>>
+			&& std::is_const<std::remove_pointer_t<decltype(tc::ptr_begin(std::declval<T&>()))>>::value
+			&& 1 == sizeof(tc::range_value_t<T>) && blob_element<tc::range_value_t<T>>;
+
+		template<typename Sink>
+		using serialize_result_t = tc::common_type_t<decltype(tc::continue_if_not_break(std::declval<Sink const&>(), std::declval<unsigned char const&>())), tc::constant<tc::continue_>>;
+
+		template<typename Sink>
+		auto serialize_varint(std::uint64_t n, Sink const& sink) MAYTHROW -> serialize_result_t<Sink> {
+			unsigned char ab[10];
+			std::size_t nBytes = 0;
+			while( 0x80 <= n ) {
+				ab[nBytes] = static_cast<unsigned char>(n | 0x80);
+				++nBytes;
+				n >>= 7;
+			}
+			ab[nBytes] = static_cast<unsigned char>(n);
+			++nBytes;
+			// One chunk, so buffered sinks copy all bytes at once.
+			return tc::for_each(tc::counted(tc::implicit_cast<unsigned char const*>(ab), nBytes), sink); // MAYTHROW
+		}
+
+		template<typename T, typename Sink>
+		auto serialize_into(T const& t, Sink const& sink) MAYTHROW -> serialize_result_t<Sink>;
+
+		template<typename T, typename Sink, std::size_t... I>
+		auto serialize_elements(T const& t, Sink const& sink, std::index_sequence<I...>) MAYTHROW -> serialize_result_t<Sink> {
+			using std::get;
+			serialize_result_t<Sink> breakorcontinue = tc::constant<tc::continue_>();
+			tc::discard((... && (tc::continue_ == (breakorcontinue = serialize_into(get<I>(t), sink))))); // MAYTHROW
+			return breakorcontinue;
+		}
+
+		template<typename T, typename Sink>
+		auto serialize_into(T const& t, Sink const& sink) MAYTHROW -> serialize_result_t<Sink> {
+			if constexpr( requires { serialize_impl(t); } ) {
+				return tc::for_each(serialize_impl(t), sink); // MAYTHROW
+			} else if constexpr( std::is_arithmetic<T>::value || std::is_enum<T>::value ) {
+				return tc::for_each(tc::as_blob(t), sink); // MAYTHROW
+			} else if constexpr( optional_like<T> ) {
+				if( t.has_value() ) {
+					tc_return_if_break(tc::for_each(tc::as_blob(true), sink)) // MAYTHROW
+					return serialize_into(*t, sink); // MAYTHROW
+				} else {
+					return tc::for_each(tc::as_blob(false), sink); // MAYTHROW
+				}
+			} else if constexpr( tc::instance<T, std::variant> ) {
+				_ASSERT( !t.valueless_by_exception() );
+				tc_return_if_break(serialize_varint(t.index(), sink)) // MAYTHROW
+				return std::visit([&](auto const& alternative) MAYTHROW -> serialize_result_t<Sink> {
+					return serialize_into(alternative, sink); // MAYTHROW
+				}, t);
+			} else if constexpr( tuple_like<T> ) {
+				return serialize_elements(t, sink, std::make_index_sequence<std::tuple_size<T>::value>()); // MAYTHROW
+			} else if constexpr( dense_map_like<T> ) {
+				return tc::for_each(t, [&](auto const& value) MAYTHROW { return serialize_into(value, sink); }); // MAYTHROW
+			} else {
+				static_assert( tc::range_with_iterators<T const>, "type is not serializable, provide serialize_impl" );
+				tc_return_if_break(serialize_varint(tc::size_linear(t), sink)) // MAYTHROW
+				if constexpr( tc::contiguous_range<T const> && blob_element<tc::range_value_t<T const>> ) {
+					return tc::for_each(tc::range_as_blob(t), sink); // MAYTHROW
+				} else {
+					return tc::for_each(t, [&](auto const& elem) MAYTHROW { return serialize_into(elem, sink); }); // MAYTHROW
+				}
+			}
+		}
+
+		inline tc::span<unsigned char const> take_bytes(tc::span<unsigned char const>& rngb, std::size_t n) THROW(tc::deserialize_failure) {
+			if( tc::size(rngb) < n ) throw tc::deserialize_failure();
+			auto const pb = tc::ptr_begin(rngb);
+			rngb = tc::make_iterator_range(pb + n, tc::ptr_end(rngb));
+			return tc::make_iterator_range(pb, pb + n);
+		}
+
+		inline std::uint64_t deserialize_varint(tc::span<unsigned char const>& rngb) THROW(tc::deserialize_failure) {
+			std::uint64_t n = 0;
+			for( int nShift = 0;; nShift += 7 ) {
+				auto const b = tc::front(take_bytes(rngb, 1)); // THROW(tc::deserialize_failure)
+				if( 63 == nShift && 1 < b ) throw tc::deserialize_failure(); // overflow or more than 10 bytes
+				n |= static_cast<std::uint64_t>(b & 0x7f) << nShift;
+				if( 0 == (b & 0x80) ) return n;
+			}
+		}
+
+		inline std::size_t deserialize_size(tc::span<unsigned char const>& rngb) THROW(tc::deserialize_failure) {
+			auto const n = deserialize_varint(rngb); // THROW(tc::deserialize_failure)
+			if( std::numeric_limits<std::size_t>::max() < n ) throw tc::deserialize_failure();
+			return tc::explicit_cast<std::size_t>(n);
+		}
+	}
+
+	// Deserializes a T from the front of rngb and removes the consumed bytes from rngb.
+	template<typename T>
+	T deserialize_head(tc::span<unsigned char const>& rngb) THROW(tc::deserialize_failure) {
+		static_assert( tc::decayed<T> );
+		if constexpr( requires { deserialize_impl(tc::type::identity<T>(), rngb); } ) {
+			return deserialize_impl(tc::type::identity<T>(), rngb); // THROW(tc::deserialize_failure)
+		} else if constexpr( std::same_as<T, bool> ) {
+			switch( tc::front(serialize_detail::take_bytes(rngb, 1)) ) { // THROW(tc::deserialize_failure)
+				case 0: return false;
+				case 1: return true;
+				default: throw tc::deserialize_failure();
+			}
+		} else if constexpr( std::is_arithmetic<T>::value || std::is_enum<T>::value ) {
+			T t;
+			std::memcpy(std::addressof(t), tc::ptr_begin(serialize_detail::take_bytes(rngb, sizeof(T))), sizeof(T)); // THROW(tc::deserialize_failure)
+			return t;
+		} else if constexpr( serialize_detail::borrowed_span<T> ) {
+			auto const rngbData = serialize_detail::take_bytes(rngb, serialize_detail::deserialize_size(rngb)); // THROW(tc::deserialize_failure)
+			using value_type = std::remove_pointer_t<decltype(tc::ptr_begin(std::declval<T&>()))>;
+			return tc::make_iterator_range(reinterpret_cast<value_type*>(tc::ptr_begin(rngbData)), reinterpret_cast<value_type*>(tc::ptr_end(rngbData)));
+		} else if constexpr( serialize_detail::optional_like<T> ) {
+			if( tc::deserialize_head<bool>(rngb) ) { // THROW(tc::deserialize_failure)
+				return T(std::in_place, tc::deserialize_head<typename T::value_type>(rngb)); // THROW(tc::deserialize_failure)
+			} else {
+				return T();
+			}
+		} else if constexpr( tc::instance<T, std::variant> ) {
+			auto const nIndex = serialize_detail::deserialize_varint(rngb); // THROW(tc::deserialize_failure)
+			if( std::variant_size<T>::value <= nIndex ) throw tc::deserialize_failure();
+			return [&]<std::size_t... I>(std::index_sequence<I...>) THROW(tc::deserialize_failure) {
+				static constexpr T(*c_afnDeserialize[])(tc::span<unsigned char const>&) = {
+					[](tc::span<unsigned char const>& rngb) THROW(tc::deserialize_failure) -> T {
+						return T(std::in_place_index<I>, tc::deserialize_head<std::variant_alternative_t<I, T>>(rngb)); // THROW(tc::deserialize_failure)
+					}...
+				};
+				return c_afnDeserialize[nIndex](rngb); // THROW(tc::deserialize_failure)
+			}(std::make_index_sequence<std::variant_size<T>::value>());
+		} else if constexpr( serialize_detail::tuple_like<T> ) {
+			return [&]<std::size_t... I>(std::index_sequence<I...>) THROW(tc::deserialize_failure) {
+				// Braced initialization evaluates the elements in order.
+				return T{tc::deserialize_head<std::remove_cv_t<std::tuple_element_t<I, T>>>(rngb)...}; // THROW(tc::deserialize_failure)
+			}(std::make_index_sequence<std::tuple_size<T>::value>());
+		} else if constexpr( serialize_detail::dense_map_like<T> ) {
+			return T(tc::func_tag, [&](auto const&) THROW(tc::deserialize_failure) {
+				return tc::deserialize_head<tc::range_value_t<T>>(rngb); // THROW(tc::deserialize_failure)
+			});
+		} else {
+			using value_type = tc::range_value_t<T>;
+			auto const n = serialize_detail::deserialize_size(rngb); // THROW(tc::deserialize_failure)
+			if constexpr( requires { T::capacity(); } ) {
+				if( T::capacity() < n ) throw tc::deserialize_failure();
+			}
+			T cont;
+			if constexpr( tc::contiguous_range<T> && serialize_detail::blob_element<value_type> ) {
+				if( tc::size(rngb) / sizeof(value_type) < n ) throw tc::deserialize_failure(); // before allocating
+				if constexpr( requires { tc::cont_extend(cont, n, boost::container::default_init); } ) {
+					tc::cont_extend(cont, n, boost::container::default_init); // overwritten below
+				} else {
+					tc::cont_extend(cont, n);
+				}
+				if( 0 < n ) {
+					std::memcpy(tc::ptr_begin(cont), tc::ptr_begin(serialize_detail::take_bytes(rngb, n * sizeof(value_type))), n * sizeof(value_type));
+				}
+			} else {
+				// n is untrusted. Elements take at least one byte unless they are empty, so this bounds the reservation by the input size.
+				tc::cont_reserve(cont, tc::min(n, tc::size(rngb)));
+				for( std::size_t i = 0; i < n; ++i ) {
+					tc::cont_emplace_back(cont, tc::deserialize_head<value_type>(rngb)); // THROW(tc::deserialize_failure)
+				}
+			}
+			return cont;
+		}
+	}
+
+	// Deserializes a T from the whole contiguous byte range rngb. Fails if bytes are left over.
+	// tc::span<char const> and other spans of const bytes in T point into rngb.
+	template<typename T, tc::contiguous_range Rng>
+	T deserialize(Rng const& rng) THROW(tc::deserialize_failure) {
+		tc::span<unsigned char const> rngb = tc::range_as_blob(rng);
+		auto t = tc::deserialize_head<T>(rngb); // THROW(tc::deserialize_failure)
+		if( !tc::empty(rngb) ) throw tc::deserialize_failure();
+		return t;
+	}
+
+	namespace no_adl {
+		template<typename T>
+		struct [[nodiscard]] serialized_impl final {
+			friend auto range_output_t_impl(serialized_impl const&) -> tc::type::list<unsigned char const&>; // declaration only
+
+			template<typename Rhs>
+			serialized_impl(aggregate_tag_t, Rhs&& rhs) noexcept
+				: m_t(aggregate_tag, std::forward<Rhs>(rhs))
+			{}
+
+			template<typename Sink>
+			auto operator()(Sink const& sink) const& MAYTHROW {
+				return serialize_detail::serialize_into(tc::as_const(*m_t), sink); // MAYTHROW
+			}
+		private:
+			tc::reference_or_value<T> m_t;
+		};
+	}
+
+	// Generator of the bytes encoding t, to be appended to a container or written to a tc::file_appender.
+	template<typename T>
+	auto serialize(T&& t) return_ctor_noexcept(
+		no_adl::serialized_impl<T>,
+		(aggregate_tag, std::forward<T>(t))
+	)
+}
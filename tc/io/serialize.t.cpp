@@ -0,0 +1,89 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../algorithm/equal.h"
+#include "../static_vector.h"
+#include "../interval.h"
+#include "serialize.h"
+
+namespace {
+	template<typename T>
+	void assert_roundtrip(T const& t) noexcept {
+		auto const vecb = tc::make_vector(tc::serialize(t));
+		try {
+			_ASSERT( t == tc::deserialize<T>(vecb) );
+		} catch( tc::deserialize_failure const& ) {
+			_ASSERTFALSE;
+		}
+	}
+
+	template<typename T, typename Rng>
+	bool deserialize_fails(Rng const& rngb) noexcept {
+		try {
+			tc::discard(tc::deserialize<T>(rngb));
+			return false;
+		} catch( tc::deserialize_failure const& ) {
+			return true;
+		}
+	}
+}
+
+UNITTESTDEF(serialize_varint) {
+	_ASSERT( tc::equal(tc::make_vector(tc::serialize(tc::vector<char>())), tc::vector<unsigned char>{0}) );
+	_ASSERT( tc::equal(tc::make_vector(tc::serialize(tc::string<char>(300, 'x'))), tc::concat(tc::vector<unsigned char>{0xac, 0x02}, tc::vector<unsigned char>(300, 'x'))) );
+	_ASSERT( tc::equal(tc::make_vector(tc::serialize(std::variant<int, bool>(true))), tc::vector<unsigned char>{1, 1}) );
+
+	_ASSERT( deserialize_fails<tc::string<char>>(tc::vector<unsigned char>{0x80}) ); // truncated varint
+	_ASSERT( deserialize_fails<tc::string<char>>(tc::vector<unsigned char>{0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f}) ); // overflow
+	_ASSERT( deserialize_fails<tc::string<char>>(tc::vector<unsigned char>{3, 'a', 'b'}) ); // truncated data
+	_ASSERT( deserialize_fails<tc::vector<tc::vector<int>>>(tc::vector<unsigned char>{0xff, 0xff, 0xff, 0xff, 0x0f}) ); // huge size
+	_ASSERT( deserialize_fails<bool>(tc::vector<unsigned char>{2}) );
+	_ASSERT( deserialize_fails<std::variant<int, bool>>(tc::vector<unsigned char>{2, 0}) );
+	_ASSERT( deserialize_fails<int>(tc::make_vector(tc::serialize(5), tc::serialize('x'))) ); // trailing bytes
+	_ASSERT( deserialize_fails<tc::static_vector<tc::string<char>, 2>>(tc::make_vector(tc::serialize(tc::vector<tc::string<char>>{"a", "b", "c"}))) );
+}
+
+UNITTESTDEF(serialize_roundtrip) {
+	assert_roundtrip(42);
+	assert_roundtrip(-1.5);
+	assert_roundtrip(tc::string<char>("abc"));
+	assert_roundtrip(tc::vector<std::uint64_t>{1, 1ull << 40});
+	assert_roundtrip(tc::vector<tc::string<char>>{"", "a", "bc"});
+	assert_roundtrip(tc::vector<bool>{true, false});
+	assert_roundtrip(std::optional<int>());
+	assert_roundtrip(std::optional<tc::string<char>>("x"));
+	assert_roundtrip(std::variant<int, tc::string<char>>("abc"));
+	assert_roundtrip(std::pair<int, tc::string<char>>(1, "a"));
+	assert_roundtrip(tc::tuple<int, bool, tc::vector<double>>{7, true, tc::vector<double>{0.5, 1.5}});
+	assert_roundtrip(tc::make_interval(3, 9));
+	assert_roundtrip(tc::vector<tc::interval<double>>{tc::make_interval(0.0, 1.0), tc::make_interval(-1.0, 2.0)});
+
+	auto const vecstr = tc::deserialize<tc::static_vector<tc::string<char>, 3>>(tc::make_vector(tc::serialize(tc::vector<tc::string<char>>{"a", "bc"})));
+	_ASSERT( tc::equal(vecstr, tc::vector<tc::string<char>>{"a", "bc"}) );
+
+	auto const ot = tc::deserialize<tc::optional<int>>(tc::make_vector(tc::serialize(tc::optional<int>(std::in_place, 5))));
+	_ASSERT( ot.has_value() );
+	_ASSERTEQUAL( *ot, 5 );
+}
+
+UNITTESTDEF(serialize_borrowed) {
+	auto const vecb = tc::make_vector(tc::serialize(tc::tuple<tc::string<char>, int>{"hello", 3}));
+	auto const tpl = tc::deserialize<tc::tuple<tc::span<char const>, int>>(vecb);
+	_ASSERT( tc::equal(tc::get<0>(tpl), "hello") );
+	_ASSERTEQUAL( tc::ptr_begin(tc::get<0>(tpl)), reinterpret_cast<char const*>(tc::ptr_begin(vecb)) + 1 ); // points into the buffer
+	_ASSERTEQUAL( tc::get<1>(tpl), 3 );
+
+	auto const vecbSequence = tc::make_vector(tc::serialize(1), tc::serialize(tc::string<char>("ab")));
+	tc::span<unsigned char const> rngb = vecbSequence;
+	_ASSERTEQUAL( tc::deserialize_head<int>(rngb), 1 );
+	_ASSERT( tc::equal(tc::deserialize_head<tc::span<char const>>(rngb), "ab") );
+	_ASSERT( tc::empty(rngb) );
+}
@@ -0,0 +1,240 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "base/assert_defs.h"
+#include "algorithm/element.h"
+#include "algorithm/empty.h"
+#include "algorithm/for_each.h"
+#include "algorithm/partition_iterator.h"
+#include "algorithm/size.h"
+#include "container/container.h"
+#include "container/cont_reserve.h"
+#include "container/insert.h"
+#include "range/subrange.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+namespace tc {
+	namespace packed_sorted_vector_detail {
+		inline constexpr std::size_t c_nBlockSize = 128;
+
+		// Unpacks n values of nBits bits each from the bit stream pn. The bit width is a template parameter, so the shifts
+		// and masks are constants and the compiler can unroll and vectorize the loop.
+		template<int nBits>
+		void unpack(std::uint64_t const* const pn, std::uint64_t* const pnOut, std::size_t const n) noexcept {
+			if constexpr( 0 == nBits ) {
+				std::fill(pnOut, pnOut + n, std::uint64_t(0));
+			} else {
+				constexpr std::uint64_t c_nMask = 64 == nBits ? ~std::uint64_t(0) : (std::uint64_t(1) << nBits) - 1;
+				for( std::size_t i = 0; i < n; ++i ) {
+					std::size_t const nBit = i * nBits;
+					std::size_t const nShift = nBit % 64;
+					std::uint64_t nValue = pn[nBit / 64] >> nShift;
+					if( 64 < nShift + nBits ) {
+						nValue |= pn[nBit / 64 + 1] << (64 - nShift);
+					}
+					pnOut[i] = nValue & c_nMask;
+				}
+			}
+		}
+
+		inline constexpr auto c_apfnUnpack = []<int... nBits>(std::integer_sequence<int, nBits...>) noexcept {
+			return std::array<void(*)(std::uint64_t const*, std::uint64_t*, std::size_t) noexcept, sizeof...(nBits)>{&unpack<nBits>...};
+		}(std::make_integer_sequence<int, 65>());
+
+		inline void pack(tc::vector<std::uint64_t>& vecnWord, std::uint64_t const* const pn, std::size_t const n, int const nBits) noexcept {
+			auto const nWordBegin = tc::size(vecnWord);
+			vecnWord.resize(nWordBegin + (n * nBits + 63) / 64, 0);
+			for( std::size_t i = 0; i < n && 0 < nBits; ++i ) {
+				std::size_t const nBit = i * nBits;
+				std::size_t const nShift = nBit % 64;
+				auto const nWord = nWordBegin + nBit / 64;
+				vecnWord[nWord] |= pn[i] << nShift;
+				if( 64 < nShift + nBits ) {
+					vecnWord[nWord + 1] |= pn[i] >> (64 - nShift);
+				}
+			}
+		}
+
+		template<typename T>
+		struct block final {
+			T m_nFirst;
+			std::size_t m_nWordBegin;
+			int m_nBits;
+		};
+	}
+
+	namespace packed_sorted_vector_adl {
+		template<typename T>
+		struct packed_sorted_vector;
+
+		// Generator range of the elements of a packed_sorted_vector from a given index on, yielding one chunk per decoded block.
+		template<typename T>
+		struct [[nodiscard]] packed_sorted_vector_from final {
+			packed_sorted_vector<T> const* m_pvec;
+			std::size_t m_nBegin;
+
+			friend auto range_output_t_impl(packed_sorted_vector_from const&) -> tc::type::list<T const&>; // declaration only
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				return m_pvec->for_each_from(m_nBegin, sink); // MAYTHROW
+			}
+		};
+
+		// Compressed container for sorted sequences of unsigned integers, e.g., ID lists. Elements are grouped into blocks of 128.
+		// Each block stores the differences between successive elements, bit-packed with the bit width of the largest difference
+		// in the block (frame of reference). A skip index holds the first element and bit width of each block, so lookups
+		// decode a single block. Dense ID lists take a few bits per element instead of 64.
+		// Iterating decodes whole blocks into a buffer and passes them to the sink as chunks.
+		template<typename T>
+		struct [[nodiscard]] packed_sorted_vector final {
+			static_assert( std::is_unsigned<T>::value && sizeof(T) <= sizeof(std::uint64_t) );
+		private:
+			friend struct packed_sorted_vector_from<T>;
+			using block_t = packed_sorted_vector_detail::block<T>;
+			static constexpr std::size_t c_nBlockSize = packed_sorted_vector_detail::c_nBlockSize;
+
+			tc::vector<block_t> m_vecblock;
+			tc::vector<std::uint64_t> m_vecnWord; // bit-packed differences of all blocks
+			tc::vector<T> m_vecnTail; // last elements, not yet a full block
+
+			void decode(std::size_t const nBlock, T* const pn) const& noexcept {
+				auto const& block = m_vecblock[nBlock];
+				std::array<std::uint64_t, c_nBlockSize - 1> anDelta;
+				packed_sorted_vector_detail::c_apfnUnpack[block.m_nBits](tc::ptr_begin(m_vecnWord) + block.m_nWordBegin, anDelta.data(), c_nBlockSize - 1);
+				T n = block.m_nFirst;
+				pn[0] = n;
+				for( std::size_t i = 1; i < c_nBlockSize; ++i ) {
+					n += static_cast<T>(anDelta[i - 1]);
+					pn[i] = n;
+				}
+			}
+
+			void pack_tail() & noexcept {
+				std::array<std::uint64_t, c_nBlockSize - 1> anDelta;
+				std::uint64_t nDeltaMax = 0;
+				for( std::size_t i = 1; i < c_nBlockSize; ++i ) {
+					anDelta[i - 1] = m_vecnTail[i] - m_vecnTail[i - 1];
+					nDeltaMax |= anDelta[i - 1];
+				}
+				int const nBits = std::bit_width(nDeltaMax);
+				tc::cont_emplace_back(m_vecblock, block_t{tc::front(m_vecnTail), tc::size(m_vecnWord), nBits});
+				packed_sorted_vector_detail::pack(m_vecnWord, anDelta.data(), c_nBlockSize - 1, nBits);
+				m_vecnTail.clear();
+			}
+
+			template<typename Sink>
+			auto for_each_from(std::size_t nBegin, Sink& sink) const& MAYTHROW {
+				using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<T const>>(), sink)), tc::constant<tc::continue_>>;
+				std::array<T, c_nBlockSize> an;
+				for( std::size_t nBlock = nBegin / c_nBlockSize; nBlock < tc::size(m_vecblock); ++nBlock ) {
+					decode(nBlock, an.data());
+					tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(an.data() + (nBegin - nBlock * c_nBlockSize), an.data() + c_nBlockSize), sink))) // MAYTHROW
+					nBegin = (nBlock + 1) * c_nBlockSize;
+				}
+				auto const nTailBegin = tc::size(m_vecblock) * c_nBlockSize;
+				return tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(tc::ptr_begin(m_vecnTail) + (nBegin - nTailBegin), tc::ptr_end(m_vecnTail)), sink)); // MAYTHROW
+			}
+
+		public:
+			using value_type = T;
+
+			packed_sorted_vector() noexcept = default;
+
+			template<typename Rng>
+			explicit packed_sorted_vector(Rng const& rng) noexcept {
+				tc::for_each(rng, [&](T const n) noexcept { push_back(n); });
+			}
+
+			// Appends n, which must not be less than the last element.
+			void push_back(T const n) & noexcept {
+				_ASSERT( empty() || back() <= n );
+				if( tc::empty(m_vecnTail) ) tc::cont_reserve(m_vecnTail, c_nBlockSize);
+				tc::cont_emplace_back(m_vecnTail, n);
+				if( c_nBlockSize == tc::size(m_vecnTail) ) pack_tail();
+			}
+
+			std::size_t size() const& noexcept {
+				return tc::size(m_vecblock) * c_nBlockSize + tc::size(m_vecnTail);
+			}
+			bool empty() const& noexcept {
+				return tc::empty(m_vecblock) && tc::empty(m_vecnTail);
+			}
+
+			// Decodes the block holding the element.
+			T operator[](std::size_t const n) const& noexcept {
+				_ASSERT( n < size() );
+				auto const nBlock = n / c_nBlockSize;
+				if( nBlock < tc::size(m_vecblock) ) {
+					std::array<T, c_nBlockSize> an;
+					decode(nBlock, an.data());
+					return an[n % c_nBlockSize];
+				} else {
+					return m_vecnTail[n - tc::size(m_vecblock) * c_nBlockSize];
+				}
+			}
+
+			T back() const& noexcept {
+				return tc::empty(m_vecnTail) ? (*this)[size() - 1] : tc::back(m_vecnTail);
+			}
+
+			// Index of the first element not less than n, like tc::lower_bound. Binary search in the skip index, then in one decoded block.
+			std::size_t lower_bound_index(T const n) const& noexcept {
+				// The first block whose first element is not less than n starts with the answer, unless its predecessor contains it.
+				auto const itBlock = tc::iterator::partition_point(tc::begin(m_vecblock), tc::end(m_vecblock), [&](block_t const& block) noexcept {
+					return block.m_nFirst < n;
+				});
+				auto const nBlock = tc::explicit_cast<std::size_t>(itBlock - tc::begin(m_vecblock));
+				if( 0 < nBlock ) {
+					std::array<T, c_nBlockSize> an;
+					decode(nBlock - 1, an.data());
+					auto const it = tc::iterator::partition_point(tc::begin(an), tc::end(an), [&](T const nElement) noexcept { return nElement < n; });
+					if( tc::end(an) != it ) return (nBlock - 1) * c_nBlockSize + tc::explicit_cast<std::size_t>(it - tc::begin(an));
+				}
+				if( nBlock < tc::size(m_vecblock) ) return nBlock * c_nBlockSize;
+				return nBlock * c_nBlockSize + tc::explicit_cast<std::size_t>(tc::iterator::partition_point(tc::begin(m_vecnTail), tc::end(m_vecnTail), [&](T const nElement) noexcept { return nElement < n; }) - tc::begin(m_vecnTail));
+			}
+
+			bool contains(T const n) const& noexcept {
+				auto const i = lower_bound_index(n);
+				return i < size() && (*this)[i] == n;
+			}
+
+			// Elements from index nBegin on.
+			packed_sorted_vector_from<T> drop_first(std::size_t const nBegin) const& noexcept {
+				_ASSERT( nBegin <= size() );
+				return {this, nBegin};
+			}
+
+			// Elements not less than n.
+			packed_sorted_vector_from<T> seek(T const n) const& noexcept {
+				return {this, lower_bound_index(n)};
+			}
+
+			// Size of the encoded data in bytes, excluding the unpacked tail.
+			std::size_t packed_bytes() const& noexcept {
+				return tc::size(m_vecblock) * sizeof(block_t) + tc::size(m_vecnWord) * sizeof(std::uint64_t);
+			}
+
+			friend auto range_output_t_impl(packed_sorted_vector const&) -> tc::type::list<T const&>; // declaration only
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				return for_each_from(0, sink); // MAYTHROW
+			}
+		};
+	}
+	using packed_sorted_vector_adl::packed_sorted_vector;
+}
@@ -0,0 +1,100 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "base/assert_defs.h"
+#include "unittest.h"
+#include "packed_sorted_vector.h"
+#include "algorithm/algorithm.h"
+
+#include <random>
+
+namespace {
+	template<typename T>
+	tc::vector<T> random_sorted(std::size_t const n, T const nGapMax, std::mt19937_64& rng) noexcept {
+		tc::vector<T> vecn;
+		T nValue = 0;
+		for( std::size_t i = 0; i < n; ++i ) {
+			nValue += static_cast<T>(rng() % (tc::explicit_cast<std::uint64_t>(nGapMax) + 1));
+			tc::cont_emplace_back(vecn, nValue);
+		}
+		return vecn;
+	}
+
+	template<typename T>
+	void test_packed_sorted_vector(tc::vector<T> const& vecn) noexcept {
+		tc::packed_sorted_vector<T> const vecnPacked(vecn);
+		_ASSERTEQUAL( tc::size(vecnPacked), tc::size(vecn) );
+		_ASSERT( tc::equal(vecnPacked, vecn) );
+		for( std::size_t i = 0; i < tc::size(vecn); i += 37 ) {
+			_ASSERTEQUAL( vecnPacked[i], vecn[i] );
+			_ASSERTEQUAL( vecnPacked.lower_bound_index(vecn[i]), tc::explicit_cast<std::size_t>(tc::lower_bound<tc::return_border>(vecn, vecn[i]) - tc::begin(vecn)) );
+			_ASSERT( vecnPacked.contains(vecn[i]) );
+			_ASSERT( tc::equal(vecnPacked.seek(vecn[i]), tc::begin_next<tc::return_drop>(vecn, tc::lower_bound<tc::return_border>(vecn, vecn[i]) - tc::begin(vecn))) );
+			_ASSERT( tc::equal(vecnPacked.drop_first(i), tc::begin_next<tc::return_drop>(vecn, i)) );
+			if( 0 < vecn[i] ) {
+				T const n = vecn[i] - 1;
+				auto const itLowerBound = tc::lower_bound<tc::return_border>(vecn, n);
+				_ASSERTEQUAL( vecnPacked.lower_bound_index(n), tc::explicit_cast<std::size_t>(itLowerBound - tc::begin(vecn)) );
+				_ASSERTEQUAL( vecnPacked.contains(n), tc::end(vecn) != itLowerBound && n == *itLowerBound );
+			}
+		}
+		if( !tc::empty(vecn) && tc::back(vecn) < std::numeric_limits<T>::max() ) {
+			_ASSERTEQUAL( vecnPacked.lower_bound_index(tc::back(vecn) + 1), tc::size(vecn) );
+			_ASSERT( tc::empty(vecnPacked.seek(tc::back(vecn) + 1)) );
+		}
+	}
+}
+
+UNITTESTDEF(packed_sorted_vector_roundtrip) {
+	std::mt19937_64 rng(42);
+	test_packed_sorted_vector(tc::vector<std::uint32_t>());
+	test_packed_sorted_vector(tc::vector<std::uint32_t>{7});
+	test_packed_sorted_vector(tc::vector<std::uint32_t>(1000, 5)); // zero differences
+	for( std::size_t n : {127, 128, 129, 256, 1000} ) {
+		test_packed_sorted_vector(random_sorted<std::uint32_t>(n, 1, rng));
+		test_packed_sorted_vector(random_sorted<std::uint32_t>(n, 1000, rng));
+		test_packed_sorted_vector(random_sorted<std::uint64_t>(n, std::uint64_t(1) << 40, rng));
+	}
+
+	tc::vector<std::uint64_t> vecnExtreme{0, 1, std::numeric_limits<std::uint64_t>::max() - 1};
+	tc::cont_extend(vecnExtreme, 200, std::numeric_limits<std::uint64_t>::max()); // 64-bit difference in the first block
+	test_packed_sorted_vector(vecnExtreme);
+}
+
+UNITTESTDEF(packed_sorted_vector_compresses) {
+	tc::packed_sorted_vector<std::uint64_t> vecn;
+	for( std::uint64_t n = 0; n < 128 * 100; ++n ) vecn.push_back(1000000 + 3 * n);
+	_ASSERTEQUAL( tc::size(vecn), 128 * 100 );
+	_ASSERTEQUAL( vecn.back(), 1000000 + 3 * (128 * 100 - 1) );
+	_ASSERT( vecn.packed_bytes() < 128 * 100 ); // 2 bits per difference plus the skip index
+}
+
+UNITTESTDEF(packed_sorted_vector_chunks) {
+	struct chunk_sink {
+		tc::vector<std::size_t>& m_vecnChunk;
+		void operator()(std::uint16_t) const& noexcept { _ASSERTFALSE; }
+		void chunk(tc::span<std::uint16_t const> span) const& noexcept {
+			tc::cont_emplace_back(m_vecnChunk, tc::size(span));
+		}
+	};
+	tc::packed_sorted_vector<std::uint16_t> vecn;
+	for( std::uint16_t n = 0; n < 300; ++n ) vecn.push_back(n);
+	tc::vector<std::size_t> vecnChunk;
+	tc::for_each(vecn, chunk_sink{vecnChunk});
+	_ASSERT( tc::equal(vecnChunk, tc::vector<std::size_t>{128, 128, 44}) );
+
+	vecnChunk.clear();
+	tc::for_each(vecn.drop_first(200), chunk_sink{vecnChunk});
+	_ASSERT( tc::equal(vecnChunk, tc::vector<std::size_t>{56, 44}) );
+
+	int nCount = 0;
+	tc::for_each(vecn, [&](std::uint16_t n) noexcept {
+		++nCount;
+		return tc::continue_if(n < 130);
+	});
+	_ASSERTEQUAL( nCount, 131 );
+}
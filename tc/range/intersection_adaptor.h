@@ -15,6 +15,62 @@
 #include "filter_adaptor.h"
 
 namespace tc {
+	namespace intersection_difference_adaptor_detail {
+		// Number of elements tc::intersect and tc::difference skip one by one before switching to exponential search.
+		// Keeps the cost on inputs of similar density close to a plain merge.
+		inline constexpr int c_nLinearSteps = 8;
+
+		// Returns the first iterator in [it, itEnd) whose element does not satisfy pred, assuming pred is true on a prefix.
+		// Costs O(log d) comparisons, where d is the distance to the result, instead of O(d) or O(log(itEnd - it)).
+		template<typename It, typename Pred>
+		It gallop_partition_point(It it, It const itEnd, Pred pred) noexcept {
+			for( int i = 0; i < c_nLinearSteps; ++i ) {
+				if( it == itEnd || !pred(tc::as_const(*it)) ) return it;
+				++it;
+			}
+			for( typename std::iterator_traits<It>::difference_type nStep = 1;; nStep *= 2 ) {
+				if( itEnd - it <= nStep ) return tc::iterator::partition_point(it, itEnd, pred);
+				auto const itProbe = it + nStep;
+				if( !pred(tc::as_const(*itProbe)) ) return tc::iterator::partition_point(it, itProbe, pred);
+				it = itProbe + 1;
+			}
+		}
+
+		template<bool bIntersection, typename Rng0, typename Rng1, typename Comp, typename Sink>
+		auto gallop_intersect_or_difference(Rng0&& rng0, Rng1&& rng1, Comp const& comp, Sink const& sink) MAYTHROW -> tc::common_type_t<
+			decltype(tc::continue_if_not_break(sink, *tc::begin(rng0))),
+			decltype(tc::for_each(tc::make_iterator_range(tc::begin(rng0), tc::end(rng0)), sink)),
+			tc::constant<tc::continue_>
+		> {
+			auto it0 = tc::begin(rng0);
+			auto const itEnd0 = tc::end(rng0);
+			auto it1 = tc::begin(rng1);
+			auto const itEnd1 = tc::end(rng1);
+			while( it0 != itEnd0 && it1 != itEnd1 ) {
+				if( auto const order = tc::invoke(comp, tc::as_const(*it0), tc::as_const(*it1)); std::is_lt(order) ) {
+					// *it0 was just compared, start after it.
+					auto const itNext0 = gallop_partition_point(it0 + 1, itEnd0, [&](auto const& elem0) noexcept { return std::is_lt(tc::invoke(comp, elem0, tc::as_const(*it1))); });
+					if constexpr( !bIntersection ) {
+						tc_return_if_break(tc::for_each(tc::make_iterator_range(it0, itNext0), sink))
+					}
+					it0 = itNext0;
+				} else if( std::is_gt(order) ) {
+					it1 = gallop_partition_point(it1 + 1, itEnd1, [&](auto const& elem1) noexcept { return std::is_gt(tc::invoke(comp, tc::as_const(*it0), elem1)); });
+				} else {
+					if constexpr( bIntersection ) {
+						tc_yield(sink, *it0);
+					}
+					++it0;
+					++it1;
+				}
+			}
+			if constexpr( !bIntersection ) {
+				tc_return_if_break(tc::for_each(tc::make_iterator_range(it0, itEnd0), sink))
+			}
+			return tc::constant<tc::continue_>();
+		}
+	}
+
 	namespace intersection_difference_adaptor_adl {
 		template<
 			bool bIntersection,
@@ -84,6 +140,18 @@ namespace tc {
 				}
 			}
 
+			// Random-access inputs of very different density skip ahead by exponential search.
+			template<tc::decayed_derived_from<intersection_difference_adaptor> Self, typename Sink> requires
+				tc::range_with_iterators<Rng1> && tc::random_access_range<Rng0> && tc::random_access_range<Rng1>
+			friend constexpr auto for_each_impl(Self&& self, Sink&& sink) MAYTHROW {
+				return intersection_difference_adaptor_detail::gallop_intersect_or_difference<bIntersection>(
+					*tc::get<0>(std::forward<Self>(self).m_tplbaserng),
+					*tc::get<1>(std::forward<Self>(self).m_tplbaserng),
+					std::forward<Self>(self).m_comp,
+					sink
+				);
+			}
+
 			template<tc::decayed_derived_from<intersection_difference_adaptor> Self, typename Sink> requires
 				tc::range_with_iterators<Rng0> && (!tc::range_with_iterators<Rng1>)
 			friend constexpr auto for_each_impl(Self&& self, Sink&& sink) MAYTHROW {
@@ -164,4 +232,50 @@ namespace tc {
 		difference(std::forward<Rng0>(rng0), std::forward<Rng1>(rng1), tc::fn_compare())
 	)
 
+	// Intersection of a range of sorted random-access ranges, e.g., posting lists, in one pass.
+	// Yields the elements of the shortest range which occur in all ranges. The other ranges are skipped ahead by
+	// exponential search, so the cost depends on the length of the shortest range rather than on the total length.
+	template<typename RngRng, typename Comp = tc::fn_compare>
+	auto intersect_many(RngRng&& rngrng, Comp comp = Comp()) noexcept {
+		auto rngrngref = tc::make_reference_or_value(std::forward<RngRng>(rngrng));
+		using iterator_t = decltype(tc::begin(std::declval<decltype(*tc::begin(*tc::as_const(rngrngref)))&>()));
+		static_assert( std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<iterator_t>::iterator_category>::value );
+		using reference_t = decltype(*std::declval<iterator_t const&>());
+		return tc::generator_range_output<reference_t>([rngrng = tc_move(rngrngref), comp = tc_move(comp)](auto&& sink) MAYTHROW
+			-> tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<reference_t>())), tc::constant<tc::continue_>>
+		{
+			tc::vector<std::pair<iterator_t, iterator_t>> vecpairit;
+			tc::for_each(*rngrng, [&](auto&& rng) noexcept {
+				tc::cont_emplace_back(vecpairit, tc::begin(rng), tc::end(rng));
+			});
+			if( tc::empty(vecpairit) ) return tc::constant<tc::continue_>();
+			// Let the shortest range propose the candidates.
+			tc::sort_inplace(vecpairit, tc::projected(tc::fn_less(), [](auto const& pairit) noexcept { return pairit.second - pairit.first; }));
+
+			auto& it0 = tc::front(vecpairit).first;
+			auto const itEnd0 = tc::front(vecpairit).second;
+			while( it0 != itEnd0 ) {
+				bool bFound = true;
+				for( auto& pairit : tc::begin_next<tc::return_drop>(vecpairit) ) {
+					auto& it = pairit.first;
+					it = intersection_difference_adaptor_detail::gallop_partition_point(it, pairit.second, [&](auto const& elem) noexcept { return std::is_lt(tc::invoke(comp, elem, tc::as_const(*it0))); });
+					if( it == pairit.second ) return tc::constant<tc::continue_>();
+					if( std::is_gt(tc::invoke(comp, tc::as_const(*it), tc::as_const(*it0))) ) {
+						// *it0 is missing from this range, continue with the next candidate that may occur in it.
+						it0 = intersection_difference_adaptor_detail::gallop_partition_point(it0, itEnd0, [&](auto const& elem) noexcept { return std::is_lt(tc::invoke(comp, elem, tc::as_const(*it))); });
+						bFound = false;
+						break;
+					}
+				}
+				if( bFound ) {
+					tc_yield(sink, *it0);
+					++it0;
+					for( auto& pairit : tc::begin_next<tc::return_drop>(vecpairit) ) {
+						++pairit.first;
+					}
+				}
+			}
+			return tc::constant<tc::continue_>();
+		});
+	}
 }
@@ -47,3 +47,43 @@ UNITTESTDEF(intersection_difference) {
 
 
 }
+
+UNITTESTDEF(intersection_difference_galloping) {
+	tc::vector<int> vecnSmall{3, 500, 501, 998, 2000};
+	tc::vector<int> vecnLarge;
+	for( int i = 0; i < 1000; ++i ) tc::cont_emplace_back(vecnLarge, i);
+	_ASSERT( tc::equal(tc::intersect(vecnSmall, vecnLarge), tc::vector<int>{3, 500, 501, 998}) );
+	_ASSERT( tc::equal(tc::intersect(vecnLarge, vecnSmall), tc::vector<int>{3, 500, 501, 998}) );
+	_ASSERT( tc::equal(tc::difference(vecnSmall, vecnLarge), tc::vector<int>{2000}) );
+	_ASSERTEQUAL( tc::size(tc::make_vector(tc::difference(vecnLarge, vecnSmall))), 996 );
+	_ASSERT( tc::equal(tc::difference(tc::vector<int>{1, 1, 2, 2, 2}, tc::vector<int>{1, 2}), tc::vector<int>{1, 2, 2}) ); // multiset semantics
+	_ASSERT( tc::equal(tc::intersect(tc::vector<int>{1, 1, 2, 2, 2}, tc::vector<int>{1, 2, 2}), tc::vector<int>{1, 2, 2}) );
+
+	// Galloping does not compare the element that was just compared again: (1, 0), then (1, 1) to end the search and (1, 1) to match.
+	int nComparisons = 0;
+	auto const CountingCompare = [&](int const lhs, int const rhs) noexcept {
+		++nComparisons;
+		return tc::compare(lhs, rhs);
+	};
+	_ASSERT( tc::equal(tc::intersect(tc::vector<int>{1}, tc::vector<int>{0, 1}, CountingCompare), tc::vector<int>{1}) );
+	_ASSERTEQUAL( nComparisons, 3 );
+
+	// Break stops the iteration.
+	int nCount = 0;
+	tc::for_each(tc::intersect(vecnLarge, vecnSmall), [&](int) noexcept { return ++nCount == 2 ? tc::break_ : tc::continue_; });
+	_ASSERTEQUAL( nCount, 2 );
+}
+
+UNITTESTDEF(intersect_many) {
+	tc::vector<tc::vector<int>> vecvecn{
+		{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20},
+		{2, 4, 6, 8, 10, 12, 14, 16, 18, 20},
+		{4, 8, 12, 16, 20, 24},
+		{0, 12, 20}
+	};
+	_ASSERT( tc::equal(tc::intersect_many(vecvecn), tc::vector<int>{12, 20}) );
+	tc::cont_emplace_back(vecvecn, tc::vector<int>{});
+	_ASSERT( tc::empty(tc::intersect_many(vecvecn)) );
+	_ASSERT( tc::empty(tc::intersect_many(tc::vector<tc::vector<int>>{})) );
+	_ASSERT( tc::equal(tc::intersect_many(tc::vector<tc::vector<int>>{{1, 1, 2}}), tc::vector<int>{1, 1, 2}) );
+}
@@ -0,0 +1,365 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "base/assert_defs.h"
+#include "algorithm/append.h"
+#include "algorithm/for_each.h"
+#include "algorithm/minmax.h"
+#include "container/container.h"
+#include "container/insert.h"
+#include "range/subrange.h"
+
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+
+#include <atomic>
+#include <utility>
+
+namespace tc {
+	namespace rope_detail {
+		inline constexpr std::size_t c_nLeafCapacity = 1024;
+
+		template<typename Char>
+		struct node;
+
+		template<typename Char>
+		using node_ptr = boost::intrusive_ptr<node<Char>>;
+
+		// Nodes are shared between copies of a rope and only modified in place while a single rope owns them.
+		// They carry their own reference count rather than using std::shared_ptr, whose use_count() is a relaxed load: unique()
+		// loads it with acquire, which orders the modification after everything other threads did before releasing the node.
+		template<typename Char>
+		struct node final {
+			std::size_t m_n;
+			int m_nHeight; // 0 for leaves
+			node_ptr<Char> m_pnodeLeft;
+			node_ptr<Char> m_pnodeRight;
+			tc::vector<Char> m_vecch; // leaves only
+			mutable std::atomic<std::size_t> m_nRef = 0;
+
+			bool leaf() const& noexcept {
+				return 0 == m_nHeight;
+			}
+
+			bool unique() const& noexcept {
+				return 1 == m_nRef.load(std::memory_order_acquire);
+			}
+
+			friend void intrusive_ptr_add_ref(node const* const pnode) noexcept {
+				pnode->m_nRef.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			friend void intrusive_ptr_release(node const* const pnode) noexcept {
+				if( 1 == pnode->m_nRef.fetch_sub(1, std::memory_order_acq_rel) ) delete pnode;
+			}
+		};
+
+		template<typename Char>
+		int height(node_ptr<Char> const& pnode) noexcept {
+			return pnode ? pnode->m_nHeight : -1;
+		}
+
+		template<typename Char>
+		std::size_t size(node_ptr<Char> const& pnode) noexcept {
+			return pnode ? pnode->m_n : 0;
+		}
+
+		template<typename Char>
+		node_ptr<Char> make_leaf(Char const* const pchBegin, Char const* const pchEnd) noexcept {
+			_ASSERT( pchBegin != pchEnd );
+			auto const n = tc::explicit_cast<std::size_t>(pchEnd - pchBegin);
+			return node_ptr<Char>(new node<Char>{n, 0, nullptr, nullptr, tc::vector<Char>(pchBegin, pchEnd)});
+		}
+
+		template<typename Char>
+		node_ptr<Char> make_node(node_ptr<Char> pnodeLeft, node_ptr<Char> pnodeRight) noexcept {
+			_ASSERT( pnodeLeft && pnodeRight );
+			_ASSERT( pnodeLeft->m_nHeight <= pnodeRight->m_nHeight + 1 && pnodeRight->m_nHeight <= pnodeLeft->m_nHeight + 1 );
+			auto const n = pnodeLeft->m_n + pnodeRight->m_n;
+			int const nHeight = tc::max(pnodeLeft->m_nHeight, pnodeRight->m_nHeight) + 1;
+			return node_ptr<Char>(new node<Char>{n, nHeight, tc_move(pnodeLeft), tc_move(pnodeRight), {}});
+		}
+
+		// Node with children whose heights differ by at most 2, rebalanced by a single or double rotation as in AVL trees.
+		template<typename Char>
+		node_ptr<Char> make_balanced(node_ptr<Char> const& pnodeLeft, node_ptr<Char> const& pnodeRight) noexcept {
+			int const nHeightLeft = height(pnodeLeft);
+			int const nHeightRight = height(pnodeRight);
+			if( nHeightRight + 1 < nHeightLeft ) {
+				auto const& pnodeLeftLeft = pnodeLeft->m_pnodeLeft;
+				auto const& pnodeLeftRight = pnodeLeft->m_pnodeRight;
+				if( height(pnodeLeftRight) <= height(pnodeLeftLeft) ) {
+					return make_node(pnodeLeftLeft, make_node(pnodeLeftRight, pnodeRight));
+				} else {
+					return make_node(make_node(pnodeLeftLeft, pnodeLeftRight->m_pnodeLeft), make_node(pnodeLeftRight->m_pnodeRight, pnodeRight));
+				}
+			} else if( nHeightLeft + 1 < nHeightRight ) {
+				auto const& pnodeRightLeft = pnodeRight->m_pnodeLeft;
+				auto const& pnodeRightRight = pnodeRight->m_pnodeRight;
+				if( height(pnodeRightLeft) <= height(pnodeRightRight) ) {
+					return make_node(make_node(pnodeLeft, pnodeRightLeft), pnodeRightRight);
+				} else {
+					return make_node(make_node(pnodeLeft, pnodeRightLeft->m_pnodeLeft), make_node(pnodeRightLeft->m_pnodeRight, pnodeRightRight));
+				}
+			} else {
+				return make_node(pnodeLeft, pnodeRight);
+			}
+		}
+
+		// Concatenation in O(|height difference| + 1). Adjacent small leaves are merged, so that many short pieces
+		// do not fragment the rope.
+		template<typename Char>
+		node_ptr<Char> join(node_ptr<Char> const& pnodeLeft, node_ptr<Char> const& pnodeRight) noexcept {
+			if( !pnodeLeft ) return pnodeRight;
+			if( !pnodeRight ) return pnodeLeft;
+			if( pnodeLeft->leaf() && pnodeRight->leaf() && pnodeLeft->m_n + pnodeRight->m_n <= c_nLeafCapacity ) {
+				node_ptr<Char> pnode(new node<Char>{pnodeLeft->m_n, 0, nullptr, nullptr, pnodeLeft->m_vecch});
+				tc::cont_reserve(pnode->m_vecch, c_nLeafCapacity);
+				tc::append(pnode->m_vecch, pnodeRight->m_vecch);
+				pnode->m_n = tc::size(pnode->m_vecch);
+				return pnode;
+			}
+			int const nHeightLeft = pnodeLeft->m_nHeight;
+			int const nHeightRight = pnodeRight->m_nHeight;
+			if( nHeightRight + 1 < nHeightLeft ) {
+				return make_balanced(pnodeLeft->m_pnodeLeft, join(pnodeLeft->m_pnodeRight, pnodeRight));
+			} else if( nHeightLeft + 1 < nHeightRight ) {
+				return make_balanced(join(pnodeLeft, pnodeRight->m_pnodeLeft), pnodeRight->m_pnodeRight);
+			} else {
+				return make_node(pnodeLeft, pnodeRight);
+			}
+		}
+
+		// Split into the first n characters and the rest in O(log n): the joins along the path telescope.
+		template<typename Char>
+		std::pair<node_ptr<Char>, node_ptr<Char>> split(node_ptr<Char> const& pnode, std::size_t const n) noexcept {
+			if( 0 == n ) return {nullptr, pnode};
+			if( size(pnode) == n ) return {pnode, nullptr};
+			_ASSERT( n < size(pnode) );
+			if( pnode->leaf() ) {
+				auto const pchBegin = tc::ptr_begin(pnode->m_vecch);
+				return {make_leaf(pchBegin, pchBegin + n), make_leaf(pchBegin + n, tc::ptr_end(pnode->m_vecch))};
+			}
+			auto const nLeft = pnode->m_pnodeLeft->m_n;
+			if( n < nLeft ) {
+				auto [pnodeFirst, pnodeSecond] = split(pnode->m_pnodeLeft, n);
+				return {tc_move(pnodeFirst), join(pnodeSecond, pnode->m_pnodeRight)};
+			} else {
+				auto [pnodeFirst, pnodeSecond] = split(pnode->m_pnodeRight, n - nLeft);
+				return {join(pnode->m_pnodeLeft, pnodeFirst), tc_move(pnodeSecond)};
+			}
+		}
+
+		// Perfectly balanced tree of the given leaves.
+		template<typename Char>
+		node_ptr<Char> build(node_ptr<Char> const* const ppnodeBegin, node_ptr<Char> const* const ppnodeEnd) noexcept {
+			if( ppnodeBegin == ppnodeEnd ) return nullptr;
+			if( ppnodeBegin + 1 == ppnodeEnd ) return *ppnodeBegin;
+			auto const ppnodeMid = ppnodeBegin + (ppnodeEnd - ppnodeBegin) / 2;
+			return make_node(build(ppnodeBegin, ppnodeMid), build(ppnodeMid, ppnodeEnd));
+		}
+
+		template<typename Char>
+		struct leaf_builder final {
+			using guaranteed_break_or_continue = tc::constant<tc::continue_>;
+
+			tc::vector<node_ptr<Char>>& m_vecpnode;
+			tc::vector<Char>& m_vecch;
+
+			void operator()(Char const ch) const& noexcept {
+				tc::cont_emplace_back(m_vecch, ch);
+				if( c_nLeafCapacity == tc::size(m_vecch) ) flush();
+			}
+
+			template<tc::contiguous_range Rng> requires std::is_same<tc::range_value_t<Rng>, Char>::value
+			void chunk(Rng const& rng) const& noexcept {
+				auto pch = tc::ptr_begin(rng);
+				auto const pchEnd = tc::ptr_end(rng);
+				while( pch != pchEnd ) {
+					auto const n = tc::min(c_nLeafCapacity - tc::size(m_vecch), tc::explicit_cast<std::size_t>(pchEnd - pch));
+					m_vecch.insert(tc::end(m_vecch), pch, pch + n);
+					pch += n;
+					if( c_nLeafCapacity == tc::size(m_vecch) ) flush();
+				}
+			}
+
+			void flush() const& noexcept {
+				if( !tc::empty(m_vecch) ) {
+					tc::cont_emplace_back(m_vecpnode, make_leaf(tc::ptr_begin(m_vecch), tc::ptr_end(m_vecch)));
+					m_vecch.clear();
+				}
+			}
+		};
+
+		template<typename Char, typename Rng>
+		node_ptr<Char> build(Rng const& rng) noexcept {
+			tc::vector<node_ptr<Char>> vecpnode;
+			tc::vector<Char> vecch;
+			leaf_builder<Char> const leafbuilder{vecpnode, vecch};
+			tc::for_each(rng, leafbuilder);
+			leafbuilder.flush();
+			return build(tc::ptr_begin(vecpnode), tc::ptr_end(vecpnode));
+		}
+	}
+
+	namespace rope_adl {
+		// Text container for large strings which are edited in the middle. Characters are stored in leaves of up to 1024 characters,
+		// which form a height-balanced binary tree, so insert, erase, split and concatenation take O(log n).
+		// Copies share all nodes, and edits copy the nodes on the path to the edited leaf, so copying a rope is a cheap snapshot.
+		// Appending to a rope which shares no nodes writes into the last leaf in place.
+		// Iterating yields each leaf as a chunk, so tc::append and tc::convert_enc copy whole leaves.
+		template<typename Char>
+		struct [[nodiscard]] rope final {
+		private:
+			using node_ptr = rope_detail::node_ptr<Char>;
+			node_ptr m_pnodeRoot;
+
+			explicit rope(node_ptr pnodeRoot) noexcept : m_pnodeRoot(tc_move(pnodeRoot)) {}
+
+			// Appends in place if the path to the last leaf is not shared and the leaf has room for rng.
+			template<tc::contiguous_range Rng>
+			bool try_append_in_place(Rng const& rng) & noexcept {
+				auto const n = tc::size(rng);
+				for( auto* ppnode = &m_pnodeRoot; ; ppnode = &(*ppnode)->m_pnodeRight ) {
+					if( !*ppnode || !(*ppnode)->unique() ) return false;
+					if( (*ppnode)->leaf() ) {
+						if( rope_detail::c_nLeafCapacity < (*ppnode)->m_n + n ) return false;
+						break;
+					}
+				}
+				for( auto* ppnode = &m_pnodeRoot; ; ppnode = &(*ppnode)->m_pnodeRight ) {
+					(*ppnode)->m_n += n;
+					if( (*ppnode)->leaf() ) {
+						auto& vecch = (*ppnode)->m_vecch;
+						tc::cont_reserve(vecch, rope_detail::c_nLeafCapacity);
+						vecch.insert(tc::end(vecch), tc::ptr_begin(rng), tc::ptr_end(rng));
+						return true;
+					}
+				}
+			}
+
+			template<typename Sink>
+			static auto for_each_leaf(rope_detail::node<Char> const& node, Sink& sink) MAYTHROW {
+				using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<Char const>>(), sink)), tc::constant<tc::continue_>>;
+				if( node.leaf() ) {
+					return tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(tc::ptr_begin(node.m_vecch), tc::ptr_end(node.m_vecch)), sink)); // MAYTHROW
+				}
+				tc_return_if_break(tc::implicit_cast<result_t>(for_each_leaf(*node.m_pnodeLeft, sink))) // MAYTHROW
+				return tc::implicit_cast<result_t>(for_each_leaf(*node.m_pnodeRight, sink)); // MAYTHROW
+			}
+
+		public:
+			using value_type = Char;
+
+			rope() noexcept = default;
+
+			template<typename Rng> requires (!std::is_same<std::remove_cvref_t<Rng>, rope>::value)
+			explicit rope(Rng const& rng) noexcept : m_pnodeRoot(rope_detail::build<Char>(rng)) {}
+
+			std::size_t size() const& noexcept {
+				return rope_detail::size(m_pnodeRoot);
+			}
+			bool empty() const& noexcept {
+				return !m_pnodeRoot;
+			}
+
+			Char operator[](std::size_t n) const& noexcept {
+				_ASSERT( n < size() );
+				auto const* pnode = m_pnodeRoot.get();
+				while( !pnode->leaf() ) {
+					auto const nLeft = pnode->m_pnodeLeft->m_n;
+					if( n < nLeft ) {
+						pnode = pnode->m_pnodeLeft.get();
+					} else {
+						n -= nLeft;
+						pnode = pnode->m_pnodeRight.get();
+					}
+				}
+				return pnode->m_vecch[n];
+			}
+
+			template<typename Rng>
+			void append(Rng const& rng) & noexcept {
+				if constexpr( tc::contiguous_range<Rng const&> ) {
+					if( tc::empty(rng) || try_append_in_place(rng) ) return;
+				}
+				m_pnodeRoot = rope_detail::join(m_pnodeRoot, rope_detail::build<Char>(rng));
+			}
+
+			void append(rope const& ropeOther) & noexcept {
+				m_pnodeRoot = rope_detail::join(m_pnodeRoot, ropeOther.m_pnodeRoot);
+			}
+
+			template<typename Rng>
+			void insert(std::size_t const n, Rng const& rng) & noexcept {
+				_ASSERT( n <= size() );
+				auto [pnodeFirst, pnodeSecond] = rope_detail::split(m_pnodeRoot, n);
+				m_pnodeRoot = rope_detail::join(rope_detail::join(pnodeFirst, rope_detail::build<Char>(rng)), pnodeSecond);
+			}
+
+			void erase(std::size_t const nBegin, std::size_t const nEnd) & noexcept {
+				_ASSERT( nBegin <= nEnd && nEnd <= size() );
+				auto [pnodeFirst, pnodeRest] = rope_detail::split(m_pnodeRoot, nBegin);
+				m_pnodeRoot = rope_detail::join(pnodeFirst, rope_detail::split(pnodeRest, nEnd - nBegin).second);
+			}
+
+			// The first n characters and the rest.
+			std::pair<rope, rope> split(std::size_t const n) const& noexcept {
+				_ASSERT( n <= size() );
+				auto [pnodeFirst, pnodeSecond] = rope_detail::split(m_pnodeRoot, n);
+				return {rope(tc_move(pnodeFirst)), rope(tc_move(pnodeSecond))};
+			}
+
+			rope substr(std::size_t const nBegin, std::size_t const nEnd) const& noexcept {
+				_ASSERT( nBegin <= nEnd && nEnd <= size() );
+				return rope(rope_detail::split(rope_detail::split(m_pnodeRoot, nEnd).first, nBegin).second);
+			}
+
+			void clear() & noexcept {
+				m_pnodeRoot = nullptr;
+			}
+
+			// Height of the tree, for tests.
+			int height() const& noexcept {
+				return rope_detail::height(m_pnodeRoot);
+			}
+
+			friend auto range_output_t_impl(rope const&) -> tc::type::list<Char const&>; // declaration only
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<Char const>>(), sink)), tc::constant<tc::continue_>>;
+				if( !m_pnodeRoot ) return tc::implicit_cast<result_t>(tc::constant<tc::continue_>());
+				return tc::implicit_cast<result_t>(for_each_leaf(*m_pnodeRoot, sink)); // MAYTHROW
+			}
+		};
+
+		template<typename Char>
+		struct rope_appender final {
+			using guaranteed_break_or_continue = tc::constant<tc::continue_>;
+
+			rope<Char>& m_rope;
+
+			void operator()(Char const ch) const& noexcept {
+				m_rope.append(tc::make_iterator_range(&ch, &ch + 1));
+			}
+
+			template<typename Rng> requires std::is_same<tc::range_value_t<Rng>, Char>::value
+			void chunk(Rng&& rng) const& noexcept {
+				m_rope.append(rng);
+			}
+		};
+
+		template<typename Char>
+		auto appender_impl(rope<Char>& rp) noexcept {
+			return rope_appender<Char>{rp};
+		}
+	}
+	using rope_adl::rope;
+}
@@ -0,0 +1,139 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "base/assert_defs.h"
+#include "unittest.h"
+#include "container/string.h"
+#include "range/repeat_n.h"
+#include "rope.h"
+
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+
+UNITTESTDEF(rope_edit) {
+	tc::rope<char> rope;
+	_ASSERT( rope.empty() );
+	rope.append("world");
+	rope.insert(0, "hello ");
+	rope.append(tc::string<char>("!"));
+	_ASSERT( tc::equal(tc::make_str<char>(rope), "hello world!") );
+	_ASSERTEQUAL( rope.size(), 12 );
+	_ASSERTEQUAL( rope[6], 'w' );
+
+	rope.erase(5, 11);
+	_ASSERT( tc::equal(tc::make_str<char>(rope), "hello!") );
+	auto const [ropeFirst, ropeSecond] = rope.split(2);
+	_ASSERT( tc::equal(tc::make_str<char>(ropeFirst), "he") );
+	_ASSERT( tc::equal(tc::make_str<char>(ropeSecond), "llo!") );
+	_ASSERT( tc::equal(tc::make_str<char>(rope.substr(1, 4)), "ell") );
+
+	// tc::append uses the rope's appender
+	tc::append(rope, " more", tc::string<char>(" text"));
+	_ASSERT( tc::equal(tc::make_str<char>(rope), "hello! more text") );
+	// and conversion chunks
+	_ASSERT( tc::equal(tc::make_str<tc::char16>(rope), u"hello! more text") );
+}
+
+UNITTESTDEF(rope_snapshot) {
+	tc::rope<char> rope(tc::repeat_n(5000, 'a'));
+	auto const ropeSnapshot = rope;
+	rope.insert(2500, "b");
+	rope.append("c");
+	rope.erase(0, 10);
+	_ASSERTEQUAL( ropeSnapshot.size(), 5000 );
+	_ASSERT( tc::equal(tc::make_str<char>(ropeSnapshot), tc::repeat_n(5000, 'a')) );
+	_ASSERTEQUAL( rope.size(), 4992 );
+	_ASSERTEQUAL( rope[2490], 'b' );
+
+	// appending after the snapshot is gone writes in place again
+	tc::rope<char> ropeAppend;
+	for( int i = 0; i < 10000; ++i ) ropeAppend.append("x");
+	_ASSERT( ropeAppend.height() <= 4 ); // full leaves of 1024 characters
+	auto const ropeAppendSnapshot = ropeAppend;
+	ropeAppend.append("y");
+	_ASSERTEQUAL( ropeAppendSnapshot.size(), 10000 );
+	_ASSERTEQUAL( ropeAppend.size(), 10001 );
+}
+
+UNITTESTDEF(rope_random_edits) {
+	std::mt19937 rng(3);
+	tc::rope<char> rope;
+	tc::string<char> str;
+	for( int i = 0; i < 2000; ++i ) {
+		auto const n = rng() % (tc::size(str) + 1);
+		switch( rng() % 4 ) {
+			case 0: {
+				tc::string<char> strInsert(rng() % 3000, static_cast<char>('a' + rng() % 26));
+				rope.insert(n, strInsert);
+				str.insert(n, strInsert);
+				break;
+			}
+			case 1: {
+				auto const nEnd = n + rng() % (tc::size(str) - n + 1);
+				rope.erase(n, nEnd);
+				str.erase(n, nEnd - n);
+				break;
+			}
+			case 2: {
+				tc::string<char> strAppend(rng() % 20, static_cast<char>('A' + rng() % 26));
+				tc::append(rope, strAppend);
+				tc::append(str, strAppend);
+				break;
+			}
+			default: {
+				auto [ropeFirst, ropeSecond] = rope.split(n);
+				ropeSecond.append(ropeFirst);
+				rope = tc_move(ropeSecond);
+				str = tc::make_str<char>(tc::begin_next<tc::return_drop>(str, n), tc::begin_next<tc::return_take>(str, n));
+			}
+		}
+		_ASSERTEQUAL( rope.size(), tc::size(str) );
+		if( 0 == i % 100 ) _ASSERT( tc::equal(tc::make_str<char>(rope), str) );
+	}
+	_ASSERT( tc::equal(tc::make_str<char>(rope), str) );
+	// height-balanced: at most about 1.44 log2 of the number of leaves
+	_ASSERT( rope.height() <= 2 * tc::explicit_cast<int>(std::bit_width(str.size() + 1)) );
+}
+
+UNITTESTDEF(rope_snapshot_threads) {
+	// An editor appends while a reader reads and drops snapshots. Appends in place must not modify nodes the reader still reads.
+	auto const Char = [](std::size_t const n) noexcept { return static_cast<char>('a' + n % 26); };
+	tc::rope<char> rope;
+	std::mutex mtx;
+	std::optional<tc::rope<char>> oropeSnapshot;
+	std::atomic<bool> bDone = false;
+	std::thread threadReader([&]() noexcept {
+		while( !bDone ) {
+			std::optional<tc::rope<char>> orope;
+			{
+				std::scoped_lock<std::mutex> lock(mtx);
+				std::swap(orope, oropeSnapshot);
+			}
+			if( orope ) {
+				auto const str = tc::make_str<char>(*orope);
+				for( std::size_t i = 0; i < tc::size(str); ++i ) _ASSERTEQUAL( str[i], Char(i) );
+			}
+		}
+	});
+	for( std::size_t i = 0; i < 50000; ++i ) {
+		char const ch = Char(i);
+		rope.append(tc::make_iterator_range(&ch, &ch + 1));
+		if( 0 == i % 100 ) {
+			std::scoped_lock<std::mutex> lock(mtx);
+			oropeSnapshot = rope;
+		}
+	}
+	bDone = true;
+	threadReader.join();
+	_ASSERTEQUAL( rope.size(), 50000 );
+	for( std::size_t i = 0; i < 50000; ++i ) _ASSERTEQUAL( rope[i], Char(i) );
+}
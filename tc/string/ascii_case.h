@@ -0,0 +1,194 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "ascii.h"
+#include "../base/assert_defs.h"
+#include "../range/meta.h"
+#include "../algorithm/for_each.h"
+#include "../algorithm/size.h"
+#include "../algorithm/equal.h"
+
+#include <compare>
+#include <cstdint>
+#include <cstring>
+
+// Bulk ASCII case conversion and case-insensitive comparison. Contiguous ranges of single-byte characters are processed
+// eight characters at a time in a std::uint64_t (SWAR), other ranges character by character with tc::toasciilower/upper.
+// Characters outside ASCII are never changed and compare by their value.
+
+namespace tc {
+	namespace ascii_case_detail {
+		inline constexpr std::uint64_t c_nOnes = 0x0101010101010101;
+
+		// Flips bit 0x20 of every byte in [chFirst, chFirst + 26). Bytes are masked to 7 bits first, so the additions
+		// cannot carry into the next byte, and bytes with the high bit set are excluded afterwards.
+		template<char chFirst>
+		constexpr std::uint64_t flip_case(std::uint64_t const n) noexcept {
+			std::uint64_t const n7 = n & (c_nOnes * 0x7f);
+			std::uint64_t const nGreaterEqualFirst = n7 + c_nOnes * (0x80 - chFirst);
+			std::uint64_t const nGreaterLast = n7 + c_nOnes * (0x80 - (chFirst + 26));
+			std::uint64_t const nLetter = nGreaterEqualFirst & ~nGreaterLast & ~n & (c_nOnes * 0x80);
+			return n ^ (nLetter >> 2);
+		}
+
+		constexpr std::uint64_t toasciilower(std::uint64_t const n) noexcept {
+			return flip_case<'A'>(n);
+		}
+
+		constexpr std::uint64_t toasciiupper(std::uint64_t const n) noexcept {
+			return flip_case<'a'>(n);
+		}
+
+		inline std::uint64_t load(void const* const pv) noexcept {
+			std::uint64_t n;
+			std::memcpy(&n, pv, sizeof(n));
+			return n;
+		}
+
+		// Byte hashed for ch. Characters of any type with the same value below 0x100 give the same byte; wider characters are
+		// folded into one byte.
+		template<typename Char>
+		constexpr unsigned char hash_byte(Char const ch) noexcept {
+			static_assert( sizeof(Char) <= sizeof(std::uint32_t) );
+			std::uint32_t const n = static_cast<std::make_unsigned_t<Char>>(ch);
+			return static_cast<unsigned char>(n ^ (n >> 8) ^ (n >> 16) ^ (n >> 24));
+		}
+
+		template<typename Rng>
+		concept bytes = tc::contiguous_range<Rng> && 1 == sizeof(tc::range_value_t<Rng>) && std::is_integral<tc::range_value_t<Rng>>::value;
+
+		template<bool bUpper, typename Rng>
+		void convert_inplace(Rng&& rng) noexcept {
+			if constexpr( bytes<Rng> ) {
+				auto* const pch = tc::ptr_begin(rng);
+				std::size_t const n = tc::size(rng);
+				std::size_t i = 0;
+				for( ; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t) ) {
+					std::uint64_t const nWord = bUpper ? toasciiupper(load(pch + i)) : toasciilower(load(pch + i));
+					std::memcpy(pch + i, &nWord, sizeof(nWord));
+				}
+				for( ; i < n; ++i ) {
+					pch[i] = bUpper ? tc::toasciiupper(pch[i]) : tc::toasciilower(pch[i]);
+				}
+			} else {
+				tc::for_each(rng, [](auto& ch) noexcept {
+					ch = bUpper ? tc::toasciiupper(ch) : tc::toasciilower(ch);
+				});
+			}
+		}
+
+		// Length of the common prefix of the words of lhs and rhs equal up to case.
+		template<typename Char>
+		std::size_t equal_words_prefix(Char const* const pchLhs, Char const* const pchRhs, std::size_t const n) noexcept {
+			std::size_t i = 0;
+			for( ; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t) ) {
+				if( toasciilower(load(pchLhs + i)) != toasciilower(load(pchRhs + i)) ) break;
+			}
+			return i;
+		}
+	}
+
+	template<typename Rng>
+	void asciiupper_inplace(Rng&& rng) noexcept {
+		ascii_case_detail::convert_inplace</*bUpper*/true>(rng);
+	}
+
+	template<typename Rng>
+	void asciilower_inplace(Rng&& rng) noexcept {
+		ascii_case_detail::convert_inplace</*bUpper*/false>(rng);
+	}
+
+	template<typename Lhs, typename Rhs>
+	[[nodiscard]] bool equal_ascii_case_insensitive(Lhs const& lhs, Rhs const& rhs) noexcept {
+		if constexpr( ascii_case_detail::bytes<Lhs const&> && ascii_case_detail::bytes<Rhs const&> ) {
+			std::size_t const n = tc::size(lhs);
+			if( tc::size(rhs) != n ) return false;
+			auto const* const pchLhs = tc::ptr_begin(lhs);
+			auto const* const pchRhs = tc::ptr_begin(rhs);
+			for( std::size_t i = ascii_case_detail::equal_words_prefix(pchLhs, pchRhs, n); i < n; ++i ) {
+				if( tc::toasciilower(pchLhs[i]) != tc::toasciilower(pchRhs[i]) ) return false;
+			}
+			return true;
+		} else {
+			return tc::equal(tc::transform_asciilower(lhs), tc::transform_asciilower(rhs));
+		}
+	}
+
+	// Orders like tc::lexicographical_compare_3way(tc::transform_asciilower(lhs), tc::transform_asciilower(rhs)).
+	template<typename Lhs, typename Rhs>
+	[[nodiscard]] std::weak_ordering lexicographical_compare_3way_ascii_case_insensitive(Lhs const& lhs, Rhs const& rhs) noexcept {
+		if constexpr( ascii_case_detail::bytes<Lhs const&> && ascii_case_detail::bytes<Rhs const&> ) {
+			std::size_t const nLhs = tc::size(lhs);
+			std::size_t const nRhs = tc::size(rhs);
+			std::size_t const n = tc::min(nLhs, nRhs);
+			auto const* const pchLhs = tc::ptr_begin(lhs);
+			auto const* const pchRhs = tc::ptr_begin(rhs);
+			for( std::size_t i = ascii_case_detail::equal_words_prefix(pchLhs, pchRhs, n); i < n; ++i ) {
+				auto const chLhs = tc::toasciilower(pchLhs[i]);
+				auto const chRhs = tc::toasciilower(pchRhs[i]);
+				if( chLhs != chRhs ) return chLhs < chRhs ? std::weak_ordering::less : std::weak_ordering::greater;
+			}
+			return nLhs <=> nRhs;
+		} else {
+			auto itLhs = tc::begin(lhs);
+			auto const itLhsEnd = tc::end(lhs);
+			auto itRhs = tc::begin(rhs);
+			auto const itRhsEnd = tc::end(rhs);
+			for( ;; ++itLhs, ++itRhs ) {
+				if( itLhs == itLhsEnd ) return itRhs == itRhsEnd ? std::weak_ordering::equivalent : std::weak_ordering::less;
+				if( itRhs == itRhsEnd ) return std::weak_ordering::greater;
+				auto const chLhs = tc::toasciilower(*itLhs);
+				auto const chRhs = tc::toasciilower(*itRhs);
+				if( chLhs != chRhs ) return chLhs < chRhs ? std::weak_ordering::less : std::weak_ordering::greater;
+			}
+		}
+	}
+
+	tc_define_fn( equal_ascii_case_insensitive );
+	tc_define_fn( lexicographical_compare_3way_ascii_case_insensitive );
+
+	// Hash consistent with tc::equal_ascii_case_insensitive, e.g., for case-insensitive hash maps of identifiers:
+	//   std::unordered_map<tc::string<char>, T, tc::fn_hash_ascii_case_insensitive, tc::fn_equal_ascii_case_insensitive>
+	struct fn_hash_ascii_case_insensitive final {
+		using is_transparent = void;
+
+		template<typename Rng>
+		[[nodiscard]] std::size_t operator()(Rng const& rng) const& noexcept {
+			std::uint64_t nHash = 0x9e3779b97f4a7c15;
+			auto const Mix = [&](std::uint64_t const n) noexcept {
+				nHash = (nHash ^ n) * 0xff51afd7ed558ccd;
+				nHash ^= nHash >> 32;
+			};
+			if constexpr( ascii_case_detail::bytes<Rng const&> ) {
+				std::size_t const n = tc::size(rng);
+				auto const* const pch = tc::ptr_begin(rng);
+				std::size_t i = 0;
+				for( ; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t) ) {
+					Mix(ascii_case_detail::toasciilower(ascii_case_detail::load(pch + i)));
+				}
+				std::uint64_t nLast = 0;
+				if( i < n ) std::memcpy(&nLast, pch + i, n - i);
+				Mix(ascii_case_detail::toasciilower(nLast) ^ n);
+			} else {
+				// Same words as above, so that transparent lookups with any range of the same text find the key.
+				unsigned char abyte[sizeof(std::uint64_t)];
+				std::size_t n = 0;
+				tc::for_each(rng, [&](auto const ch) noexcept {
+					abyte[n % sizeof(std::uint64_t)] = ascii_case_detail::hash_byte(tc::toasciilower(ch));
+					if( 0 == ++n % sizeof(std::uint64_t) ) Mix(ascii_case_detail::load(abyte));
+				});
+				std::uint64_t nLast = 0;
+				std::memcpy(&nLast, abyte, n % sizeof(std::uint64_t));
+				Mix(nLast ^ n);
+			}
+			return static_cast<std::size_t>(nHash);
+		}
+	};
+}
@@ -0,0 +1,66 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../container/insert.h"
+#include "../container/string.h"
+#include "../algorithm/compare.h"
+#include "../range/filter_adaptor.h"
+#include "ascii_case.h"
+
+#include <unordered_set>
+
+static_assert( tc::ascii_case_detail::toasciilower(0x4041425a5b606162) == 0x4061627a5b606162 ); // @ABZ[`ab
+static_assert( tc::ascii_case_detail::toasciiupper(0x607a7b61c1e1ff40) == 0x605a7b41c1e1ff40 ); // `z{a and non-ASCII bytes
+
+UNITTESTDEF(ascii_case_inplace) {
+	// every byte value, so the word-wise conversion must agree with the character-wise one
+	tc::string<char> str;
+	for( int n = 0; n < 256; ++n ) tc::cont_emplace_back(str, static_cast<char>(n));
+	auto strUpper = str;
+	tc::asciiupper_inplace(strUpper);
+	_ASSERT( tc::equal(strUpper, tc::transform_asciiupper(str)) );
+	auto strLower = str;
+	tc::asciilower_inplace(strLower);
+	_ASSERT( tc::equal(strLower, tc::transform_asciilower(str)) );
+
+	tc::string<tc::char16> str16 = u"Mixed Case Ä";
+	tc::asciilower_inplace(str16);
+	_ASSERT( tc::equal(str16, u"mixed case Ä") );
+}
+
+UNITTESTDEF(ascii_case_insensitive_compare) {
+	_ASSERT( tc::equal_ascii_case_insensitive("Content-Length", "content-length") );
+	_ASSERT( tc::equal_ascii_case_insensitive("", "") );
+	_ASSERT( !tc::equal_ascii_case_insensitive("Content-Length", "content-lengtx") );
+	_ASSERT( !tc::equal_ascii_case_insensitive("Content-Length", "content-lengt") );
+	_ASSERT( !tc::equal_ascii_case_insensitive("[", "{") ); // differ by 0x20, but are no letters
+	_ASSERT( tc::equal_ascii_case_insensitive(u"Host", u"hOST") );
+
+	_ASSERTEQUAL( tc::lexicographical_compare_3way_ascii_case_insensitive("Accept-Encoding", "accept-language"), std::weak_ordering::less );
+	_ASSERTEQUAL( tc::lexicographical_compare_3way_ascii_case_insensitive("ACCEPT", "accept"), std::weak_ordering::equivalent );
+	_ASSERTEQUAL( tc::lexicographical_compare_3way_ascii_case_insensitive("accept-x", "ACCEPT"), std::weak_ordering::greater );
+	_ASSERTEQUAL( tc::lexicographical_compare_3way_ascii_case_insensitive("_", "A"), std::weak_ordering::less ); // compares as lower case
+	_ASSERTEQUAL( tc::lexicographical_compare_3way_ascii_case_insensitive(u"b", u"A"), std::weak_ordering::greater );
+
+	tc::fn_hash_ascii_case_insensitive const hash;
+	_ASSERTEQUAL( hash("Transfer-Encoding"), hash(tc::string<char>("TRANSFER-encoding")) );
+	_ASSERTEQUAL( hash(u"Transfer-Encoding"), hash(u"TRANSFER-encoding") );
+	// Contiguous byte ranges are hashed word by word, other ranges character by character, with the same result.
+	_ASSERTEQUAL( hash(tc::string<char>("HelloWorld")), hash(u"helloworld") );
+	_ASSERTEQUAL( hash(tc::string<char>("HelloWorld")), hash(tc::filter("HelloWorld", [](char) noexcept { return true; })) );
+	_ASSERTEQUAL( hash("Accept"), hash(U"ACCEPT") );
+	_ASSERTEQUAL( hash(""), hash(u"") );
+
+	std::unordered_set<tc::string<char>, tc::fn_hash_ascii_case_insensitive, tc::fn_equal_ascii_case_insensitive> setstr;
+	setstr.emplace("Content-Type");
+	setstr.emplace("content-type");
+	setstr.emplace("Content-Length");
+	_ASSERTEQUAL( setstr.size(), 2 );
+	_ASSERT( setstr.contains(tc::string<char>("CONTENT-LENGTH")) );
+}
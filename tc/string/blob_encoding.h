@@ -0,0 +1,277 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../algorithm/for_each.h"
+#include "../algorithm/size.h"
+#include "../range/meta.h"
+#include "../range/range_adaptor.h"
+#include "../range/subrange.h"
+#include "format.h"
+
+#include <array>
+#include <cstdint>
+
+// Hex and base64 encoding of byte ranges and decoding back to bytes, as generator ranges.
+// Input is processed in blocks through lookup tables: contiguous ranges of bytes or characters in place, other ranges through
+// a stack buffer. Each block of output is passed to the sink as one chunk.
+
+namespace tc {
+	// Thrown by the decoders. m_nPosition is the index of the first invalid character, or the size of the input if it is truncated.
+	struct blob_decode_exception final {
+		std::size_t m_nPosition;
+	};
+
+	namespace blob_encoding_detail {
+		inline constexpr unsigned char c_byteInvalid = 0xff;
+
+		inline constexpr char c_achBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+		template<tc::casing c>
+		inline constexpr auto c_aachHex = []() noexcept {
+			std::array<std::array<char, 2>, 256> aach{};
+			for( int n = 0; n < 256; ++n ) {
+				for( int i = 0; i < 2; ++i ) {
+					int const nDigit = 0 == i ? n >> 4 : n & 0xf;
+					aach[n][i] = static_cast<char>(nDigit < 10 ? '0' + nDigit : (tc::lowercase == c ? 'a' : 'A') + (nDigit - 10));
+				}
+			}
+			return aach;
+		}();
+
+		inline constexpr auto c_abyteHexValue = []() noexcept {
+			std::array<unsigned char, 256> abyte{};
+			for( int n = 0; n < 256; ++n ) {
+				abyte[n] = '0' <= n && n <= '9' ? static_cast<unsigned char>(n - '0')
+					: 'a' <= n && n <= 'f' ? static_cast<unsigned char>(n - 'a' + 10)
+					: 'A' <= n && n <= 'F' ? static_cast<unsigned char>(n - 'A' + 10)
+					: c_byteInvalid;
+			}
+			return abyte;
+		}();
+
+		inline constexpr auto c_abyteBase64Value = []() noexcept {
+			std::array<unsigned char, 256> abyte{};
+			for( auto& byte : abyte ) byte = c_byteInvalid;
+			for( int n = 0; n < 64; ++n ) abyte[static_cast<unsigned char>(c_achBase64[n])] = static_cast<unsigned char>(n);
+			return abyte;
+		}();
+
+		template<tc::casing c>
+		struct hex final {
+			static constexpr std::size_t c_nBytesPerGroup = 1;
+			static constexpr std::size_t c_nCharsPerGroup = 2;
+
+			static std::size_t encode(unsigned char const* const pbyte, std::size_t const n, tc::char_ascii* const pch) noexcept {
+				for( std::size_t i = 0; i < n; ++i ) {
+					auto const& ach = c_aachHex<c>[pbyte[i]];
+					pch[2 * i] = tc::char_ascii(ach[0]);
+					pch[2 * i + 1] = tc::char_ascii(ach[1]);
+				}
+				return 2 * n;
+			}
+
+			// nPosition is the position of pch in the whole input. n is even unless bLast.
+			static std::size_t decode(unsigned char const* const pch, std::size_t const n, [[maybe_unused]] bool const bLast, unsigned char* const pbyte, std::size_t const nPosition) THROW(tc::blob_decode_exception) {
+				for( std::size_t i = 0; i < n / 2; ++i ) {
+					auto const byteHigh = c_abyteHexValue[pch[2 * i]];
+					auto const byteLow = c_abyteHexValue[pch[2 * i + 1]];
+					if( 0 != ((byteHigh | byteLow) & 0x80) ) {
+						throw tc::blob_decode_exception{nPosition + 2 * i + (c_byteInvalid == byteHigh ? 0 : 1)};
+					}
+					pbyte[i] = static_cast<unsigned char>(byteHigh << 4 | byteLow);
+				}
+				if( 0 != n % 2 ) {
+					_ASSERT( bLast );
+					throw tc::blob_decode_exception{nPosition + n - (c_byteInvalid == c_abyteHexValue[pch[n - 1]] ? 1 : 0)};
+				}
+				return n / 2;
+			}
+		};
+
+		struct base64 final {
+			static constexpr std::size_t c_nBytesPerGroup = 3;
+			static constexpr std::size_t c_nCharsPerGroup = 4;
+
+			// n is a multiple of 3 unless this is the last block, which is padded with '='.
+			static std::size_t encode(unsigned char const* const pbyte, std::size_t const n, tc::char_ascii* const pch) noexcept {
+				std::size_t i = 0;
+				std::size_t j = 0;
+				for( ; i + 3 <= n; i += 3, j += 4 ) {
+					std::uint32_t const nGroup = std::uint32_t(pbyte[i]) << 16 | std::uint32_t(pbyte[i + 1]) << 8 | pbyte[i + 2];
+					pch[j] = tc::char_ascii(c_achBase64[nGroup >> 18]);
+					pch[j + 1] = tc::char_ascii(c_achBase64[(nGroup >> 12) & 0x3f]);
+					pch[j + 2] = tc::char_ascii(c_achBase64[(nGroup >> 6) & 0x3f]);
+					pch[j + 3] = tc::char_ascii(c_achBase64[nGroup & 0x3f]);
+				}
+				if( i < n ) {
+					std::uint32_t const nGroup = std::uint32_t(pbyte[i]) << 16 | (i + 1 < n ? std::uint32_t(pbyte[i + 1]) << 8 : 0);
+					pch[j] = tc::char_ascii(c_achBase64[nGroup >> 18]);
+					pch[j + 1] = tc::char_ascii(c_achBase64[(nGroup >> 12) & 0x3f]);
+					pch[j + 2] = i + 1 < n ? tc::char_ascii(c_achBase64[(nGroup >> 6) & 0x3f]) : tc::char_ascii('=');
+					pch[j + 3] = tc::char_ascii('=');
+					j += 4;
+				}
+				return j;
+			}
+
+			// nPosition is the position of pch in the whole input. n is a multiple of 4 unless bLast.
+			// The last block may end with one or two '=' if its size is a multiple of 4; padding is optional.
+			static std::size_t decode(unsigned char const* const pch, std::size_t n, bool const bLast, unsigned char* const pbyte, std::size_t const nPosition) THROW(tc::blob_decode_exception) {
+				auto const Throw = [&](std::size_t i) THROW(tc::blob_decode_exception) {
+					// first invalid character at or after i
+					while( i < n && c_byteInvalid != c_abyteBase64Value[pch[i]] ) ++i;
+					throw tc::blob_decode_exception{nPosition + i};
+				};
+				if( bLast ) {
+					if( 0 < n && 0 == n % 4 && '=' == pch[n - 1] ) {
+						--n;
+						if( '=' == pch[n - 1] ) --n;
+					}
+				}
+				std::size_t i = 0;
+				std::size_t j = 0;
+				for( ; i + 4 <= n; i += 4, j += 3 ) {
+					auto const byte0 = c_abyteBase64Value[pch[i]];
+					auto const byte1 = c_abyteBase64Value[pch[i + 1]];
+					auto const byte2 = c_abyteBase64Value[pch[i + 2]];
+					auto const byte3 = c_abyteBase64Value[pch[i + 3]];
+					if( 0 != ((byte0 | byte1 | byte2 | byte3) & 0x80) ) Throw(i);
+					std::uint32_t const nGroup = std::uint32_t(byte0) << 18 | std::uint32_t(byte1) << 12 | std::uint32_t(byte2) << 6 | byte3;
+					pbyte[j] = static_cast<unsigned char>(nGroup >> 16);
+					pbyte[j + 1] = static_cast<unsigned char>(nGroup >> 8);
+					pbyte[j + 2] = static_cast<unsigned char>(nGroup);
+				}
+				if( i + 1 == n ) { // a single character does not encode a byte
+					if( c_byteInvalid == c_abyteBase64Value[pch[i]] ) Throw(i);
+					throw tc::blob_decode_exception{nPosition + n};
+				} else if( i < n ) {
+					auto const byte0 = c_abyteBase64Value[pch[i]];
+					auto const byte1 = c_abyteBase64Value[pch[i + 1]];
+					auto const byte2 = i + 2 < n ? c_abyteBase64Value[pch[i + 2]] : 0;
+					if( 0 != ((byte0 | byte1 | byte2) & 0x80) ) Throw(i);
+					std::uint32_t const nGroup = std::uint32_t(byte0) << 18 | std::uint32_t(byte1) << 12 | std::uint32_t(byte2) << 6;
+					pbyte[j] = static_cast<unsigned char>(nGroup >> 16);
+					++j;
+					if( i + 2 < n ) {
+						pbyte[j] = static_cast<unsigned char>(nGroup >> 8);
+						++j;
+					}
+				}
+				return j;
+			}
+		};
+
+		// Ranges of 1-byte elements, e.g., char, unsigned char, std::byte or tc::char_ascii, are read in place.
+		template<typename Rng>
+		concept contiguous_bytes = tc::contiguous_range<Rng> && 1 == sizeof(tc::range_value_t<Rng>);
+
+		template<typename T>
+		constexpr unsigned char to_byte(T const& t) noexcept {
+			if constexpr( 1 == sizeof(T) ) {
+				return static_cast<unsigned char>(t);
+			} else {
+				// Only decoding reads wider elements, i.e., characters. Characters outside of ASCII are invalid in encoded text.
+				// Do not let them alias valid characters by truncation.
+				return t < 0x80 ? static_cast<unsigned char>(t) : static_cast<unsigned char>(0x80);
+			}
+		}
+
+		inline constexpr std::size_t c_nGroupsPerBlock = 64;
+
+		// Feeds the bytes of rng to func in blocks of nBlock bytes; only the last block may be shorter.
+		template<std::size_t nBlock, typename Rng, typename Func>
+		auto for_each_block(Rng const& rng, Func func) MAYTHROW {
+			using result_t = tc::common_type_t<decltype(func(std::declval<unsigned char const*>(), std::size_t(), true)), tc::constant<tc::continue_>>;
+			if constexpr( contiguous_bytes<Rng const&> ) {
+				auto const* pbyte = reinterpret_cast<unsigned char const*>(tc::ptr_begin(rng));
+				std::size_t n = tc::size(rng);
+				for( ; nBlock < n; pbyte += nBlock, n -= nBlock ) {
+					tc_return_if_break(tc::implicit_cast<result_t>(func(pbyte, nBlock, false))) // MAYTHROW
+				}
+				return tc::implicit_cast<result_t>(func(pbyte, n, true)); // MAYTHROW
+			} else {
+				std::array<unsigned char, nBlock> abyte;
+				std::size_t n = 0;
+				tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(rng, [&](auto const& t) MAYTHROW -> result_t {
+					if( nBlock == n ) {
+						tc_return_if_break(tc::implicit_cast<result_t>(func(abyte.data(), n, false))) // MAYTHROW
+						n = 0;
+					}
+					abyte[n] = to_byte(t);
+					++n;
+					return tc::constant<tc::continue_>();
+				})))
+				return tc::implicit_cast<result_t>(func(abyte.data(), n, true)); // MAYTHROW
+			}
+		}
+	}
+
+	namespace blob_encoding_adl {
+		template<typename Encoding, typename Rng>
+		struct [[nodiscard]] encode_impl final : private tc::range_adaptor_base_range<Rng> {
+			friend auto range_output_t_impl(encode_impl const&) -> tc::type::list<tc::char_ascii const&>; // declaration only
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				std::array<tc::char_ascii, blob_encoding_detail::c_nGroupsPerBlock * Encoding::c_nCharsPerGroup> ach;
+				return blob_encoding_detail::for_each_block<blob_encoding_detail::c_nGroupsPerBlock * Encoding::c_nBytesPerGroup>(this->base_range(), [&](unsigned char const* pbyte, std::size_t n, bool /*bLast*/) MAYTHROW {
+					return tc::for_each(tc::make_iterator_range(ach.data(), ach.data() + Encoding::encode(pbyte, n, ach.data())), sink); // MAYTHROW
+				});
+			}
+		};
+
+		template<typename Encoding, typename Rng>
+		struct [[nodiscard]] decode_impl final : private tc::range_adaptor_base_range<Rng> {
+			friend auto range_output_t_impl(decode_impl const&) -> tc::type::list<unsigned char const&>; // declaration only
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& THROW(tc::blob_decode_exception) {
+				std::array<unsigned char, blob_encoding_detail::c_nGroupsPerBlock * Encoding::c_nBytesPerGroup> abyte;
+				std::size_t nPosition = 0;
+				return blob_encoding_detail::for_each_block<blob_encoding_detail::c_nGroupsPerBlock * Encoding::c_nCharsPerGroup>(this->base_range(), [&](unsigned char const* pch, std::size_t n, bool bLast) THROW(tc::blob_decode_exception) {
+					auto const nBytes = Encoding::decode(pch, n, bLast, abyte.data(), nPosition); // THROW(tc::blob_decode_exception)
+					nPosition += n;
+					return tc::for_each(tc::make_iterator_range(abyte.data(), abyte.data() + nBytes), sink); // MAYTHROW
+				});
+			}
+		};
+	}
+
+	// Encodes a range of bytes as two hex digits per byte.
+	template<tc::casing c = tc::uppercase, typename Rng> requires (1 == sizeof(tc::range_value_t<Rng>))
+	auto as_hex_blob(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(blob_encoding_adl::encode_impl<blob_encoding_detail::hex<c>, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Encodes a range of bytes as base64 (RFC 4648) with padding.
+	template<typename Rng> requires (1 == sizeof(tc::range_value_t<Rng>))
+	auto as_base64(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(blob_encoding_adl::encode_impl<blob_encoding_detail::base64, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Decodes hex digits of either case to bytes. Iterating throws tc::blob_decode_exception on invalid input.
+	template<typename Rng>
+	auto hex_blob_from_string(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(blob_encoding_adl::decode_impl<blob_encoding_detail::hex<tc::uppercase>, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Decodes base64 with optional padding to bytes. Iterating throws tc::blob_decode_exception on invalid input.
+	template<typename Rng>
+	auto base64_decode(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(blob_encoding_adl::decode_impl<blob_encoding_detail::base64, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+}
@@ -0,0 +1,91 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../container/string.h"
+#include "../range/transform.h"
+#include "blob_encoding.h"
+
+#include <random>
+
+namespace {
+	template<typename Rng>
+	auto bytes(Rng const& rng) noexcept {
+		return tc::make_vector(tc::transform(rng, tc::fn_static_cast<unsigned char>()));
+	}
+
+	template<typename Rng>
+	std::optional<std::size_t> decode_error(Rng const& rng) noexcept {
+		try {
+			tc::for_each(rng, tc::noop());
+			return std::nullopt;
+		} catch( tc::blob_decode_exception const& e ) {
+			return e.m_nPosition;
+		}
+	}
+}
+
+UNITTESTDEF(blob_encoding_rfc4648) {
+	// test vectors of RFC 4648
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("")), "") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("f")), "Zg==") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("fo")), "Zm8=") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("foo")), "Zm9v") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("foob")), "Zm9vYg==") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("fooba")), "Zm9vYmE=") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64("foobar")), "Zm9vYmFy") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_hex_blob("foobar")), "666F6F626172") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_hex_blob<tc::lowercase>(tc::vector<unsigned char>{0x00, 0xab, 0xff})), "00abff") );
+
+	_ASSERT( tc::equal(tc::make_vector(tc::base64_decode("Zm9vYmE=")), bytes("fooba")) );
+	_ASSERT( tc::equal(tc::make_vector(tc::base64_decode("Zm9vYmE")), bytes("fooba")) ); // padding is optional
+	_ASSERT( tc::equal(tc::make_vector(tc::base64_decode("Zm9vYg==")), bytes("foob")) );
+	_ASSERT( tc::equal(tc::make_vector(tc::hex_blob_from_string("666f6F626172")), bytes("foobar")) );
+	_ASSERT( tc::equal(tc::make_vector(tc::base64_decode(u"Zm9vYmFy")), bytes("foobar")) );
+}
+
+UNITTESTDEF(blob_encoding_errors) {
+	_ASSERT( !decode_error(tc::base64_decode("Zm9vYmFy")) );
+	_ASSERTEQUAL( decode_error(tc::base64_decode("Zm9v*mFy")), 4 );
+	_ASSERTEQUAL( decode_error(tc::base64_decode("Zm=vYmFy")), 2 ); // padding inside
+	_ASSERTEQUAL( decode_error(tc::base64_decode("Zm9vY")), 5 ); // truncated
+	_ASSERTEQUAL( decode_error(tc::base64_decode("Z===")), 1 );
+	_ASSERTEQUAL( decode_error(tc::base64_decode(u"Zm9vŚ")), 4 ); // must not be truncated to 'Z'
+	_ASSERTEQUAL( decode_error(tc::hex_blob_from_string("0g")), 1 );
+	_ASSERTEQUAL( decode_error(tc::hex_blob_from_string("abc")), 3 );
+
+	// errors in later blocks report positions in the whole input
+	auto str = tc::make_str<char>(tc::as_base64(tc::repeat_n(1000, 'x')));
+	str[900] = '!';
+	_ASSERTEQUAL( decode_error(tc::base64_decode(str)), 900 );
+	_ASSERTEQUAL( decode_error(tc::base64_decode(tc::transform(str, tc::fn_static_cast<char>()))), 900 );
+}
+
+UNITTESTDEF(blob_encoding_roundtrip) {
+	std::mt19937 rng(42);
+	for( std::size_t n : {0, 1, 2, 3, 191, 192, 193, 1000} ) {
+		tc::vector<unsigned char> vecbyte;
+		for( std::size_t i = 0; i < n; ++i ) tc::cont_emplace_back(vecbyte, static_cast<unsigned char>(rng()));
+		auto const strBase64 = tc::make_str<char>(tc::as_base64(vecbyte));
+		_ASSERTEQUAL( tc::size(strBase64), (n + 2) / 3 * 4 );
+		_ASSERT( tc::equal(tc::make_vector(tc::base64_decode(strBase64)), vecbyte) );
+		auto const strHex = tc::make_str<char>(tc::as_hex_blob(vecbyte));
+		_ASSERTEQUAL( tc::size(strHex), 2 * n );
+		_ASSERT( tc::equal(tc::make_vector(tc::hex_blob_from_string(strHex)), vecbyte) );
+
+		// non-contiguous input takes the buffered path
+		auto const rngbyteTransformed = tc::transform(vecbyte, tc::fn_static_cast<unsigned char>());
+		_ASSERT( tc::equal(tc::make_str<char>(tc::as_base64(rngbyteTransformed)), strBase64) );
+		_ASSERT( tc::equal(tc::make_str<char>(tc::as_hex_blob(rngbyteTransformed)), strHex) );
+	}
+
+	// Wider elements are not bytes, and are not silently narrowed.
+	static_assert( ![](auto const& vecn) { return requires { tc::as_hex_blob(vecn); }; }(tc::vector<int>{200, 0x41}) );
+	static_assert( ![](auto const& vecn) { return requires { tc::as_base64(vecn); }; }(tc::vector<unsigned short>{0xff}) );
+}
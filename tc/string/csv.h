@@ -0,0 +1,238 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/bitfield.h"
+#include "../algorithm/empty.h"
+#include "../algorithm/find.h"
+#include "../algorithm/for_each.h"
+#include "../algorithm/minmax.h"
+#include "../container/container.h"
+#include "../container/insert.h"
+#include "../range/range_adaptor.h"
+#include "../range/subrange.h"
+
+#include <cstdint>
+
+// Reader for delimiter-separated values (RFC 4180), e.g., CSV and TSV. Like tc::json_tokens, it works in two stages:
+// the first stage computes bit masks of quotes, delimiters and line feeds for 64 characters at a time, and masks out delimiters
+// and line feeds between quotes with a prefix xor of the quote mask. The second stage only visits the remaining positions and
+// the quotes, which it checks. Fields refer to the input; only fields with doubled quotes need unescaping, when they are read.
+
+namespace tc {
+	// Thrown while iterating tc::csv_rows. m_nPosition is the index of the offending character.
+	struct csv_parse_exception final {
+		std::size_t m_nPosition;
+	};
+
+	// tc::csv_options{'\t'} reads TSV.
+	struct csv_options final {
+		char m_chDelimiter = ',';
+		char m_chQuote = '"';
+	};
+
+	// Field of a row of tc::csv_rows. As a range, it is the value of the field with quotes unescaped.
+	template<typename Char>
+	struct csv_field final {
+		tc::span<Char const> m_str; // without enclosing quotes, escaped quotes still doubled if m_bEscaped
+		bool m_bEscaped;
+		Char m_chQuote;
+
+		friend auto range_output_t_impl(csv_field const&) -> tc::type::list<Char const&>; // declaration only
+
+		template<typename Sink>
+		auto operator()(Sink&& sink) const& MAYTHROW {
+			using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<Char const>>(), sink)), tc::constant<tc::continue_>>;
+			if( !m_bEscaped ) return tc::implicit_cast<result_t>(tc::for_each(m_str, sink)); // MAYTHROW
+			// Yield each doubled quote as the end of a chunk and skip its second quote.
+			Char const* pch = tc::ptr_begin(m_str);
+			Char const* const pchEnd = tc::ptr_end(m_str);
+			while( pch != pchEnd ) {
+				Char const* const pchQuote = tc::find_first<tc::return_element_or_null>(tc::make_iterator_range(pch, pchEnd), m_chQuote);
+				if( !pchQuote ) break;
+				tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(pch, pchQuote + 1), sink))) // MAYTHROW
+				_ASSERTEQUAL( pchQuote[1], m_chQuote );
+				pch = pchQuote + 2;
+			}
+			return tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(pch, pchEnd), sink)); // MAYTHROW
+		}
+	};
+
+	namespace csv_detail {
+		inline constexpr std::size_t c_nBlockSize = 64;
+
+		struct block_masks final {
+			std::uint64_t m_nQuote = 0;
+			std::uint64_t m_nDelimiter = 0;
+			std::uint64_t m_nLineFeed = 0;
+		};
+
+		template<typename Char>
+		block_masks classify(Char const* const pch, std::size_t const n, Char const chDelimiter, Char const chQuote) noexcept {
+			block_masks masks;
+			for( std::size_t i = 0; i < n; ++i ) {
+				masks.m_nQuote |= std::uint64_t(chQuote == pch[i]) << i;
+				masks.m_nDelimiter |= std::uint64_t(chDelimiter == pch[i]) << i;
+				masks.m_nLineFeed |= std::uint64_t(tc::explicit_cast<Char>('\n') == pch[i]) << i;
+			}
+			return masks;
+		}
+
+		// Second stage. Collects the fields of the current row.
+		template<typename Char>
+		struct row_builder final {
+			row_builder(Char const* const pchBegin, Char const* const pchEnd, Char const chDelimiter, Char const chQuote) noexcept
+				: m_pchBegin(pchBegin)
+				, m_pchEnd(pchEnd)
+				, m_chDelimiter(chDelimiter)
+				, m_chQuote(chQuote)
+				, m_pchField(pchBegin)
+			{}
+
+			void quote(Char const* const pch) & THROW(tc::csv_parse_exception) {
+				if( m_bSkipQuote ) { // second quote of a doubled quote
+					m_bSkipQuote = false;
+				} else if( pch == m_pchField ) {
+					m_bQuoted = true;
+				} else if( !m_bQuoted || m_pchQuoteEnd ) {
+					error(pch); // quote inside an unquoted field or after the closing quote
+				} else if( pch + 1 != m_pchEnd && m_chQuote == pch[1] ) {
+					m_bEscaped = true;
+					m_bSkipQuote = true;
+				} else {
+					m_pchQuoteEnd = pch;
+					Char const* const pchNext = pch + 1;
+					if( pchNext != m_pchEnd && m_chDelimiter != *pchNext && '\n' != *pchNext
+						&& !('\r' == *pchNext && (pchNext + 1 == m_pchEnd || '\n' == pchNext[1]))
+					) {
+						error(pchNext);
+					}
+				}
+			}
+
+			// pch is the delimiter or line feed, or the end of the input, after the field.
+			void end_field(Char const* const pch, bool const bEndOfRow) & THROW(tc::csv_parse_exception) {
+				if( m_bQuoted ) {
+					if( !m_pchQuoteEnd ) error(m_pchField); // unterminated quoted field
+					tc::cont_emplace_back(m_vecfield, tc::csv_field<Char>{tc::make_iterator_range(m_pchField + 1, m_pchQuoteEnd), m_bEscaped, m_chQuote});
+				} else {
+					Char const* pchFieldEnd = pch;
+					if( bEndOfRow && m_pchField != pchFieldEnd && '\r' == pchFieldEnd[-1] ) --pchFieldEnd; // CRLF
+					tc::cont_emplace_back(m_vecfield, tc::csv_field<Char>{tc::make_iterator_range(m_pchField, pchFieldEnd), false, m_chQuote});
+				}
+				m_pchField = pch == m_pchEnd ? pch : pch + 1;
+				m_bQuoted = false;
+				m_bEscaped = false;
+				m_pchQuoteEnd = nullptr;
+			}
+
+			// Whether the input ends with an unterminated row.
+			bool pending_row() const& noexcept {
+				return m_pchField != m_pchEnd || !tc::empty(m_vecfield);
+			}
+
+			tc::span<tc::csv_field<Char> const> row() const& noexcept {
+				return tc::make_iterator_range(tc::ptr_begin(m_vecfield), tc::ptr_end(m_vecfield));
+			}
+
+			void clear_row() & noexcept {
+				m_vecfield.clear();
+			}
+
+		private:
+			[[noreturn]] void error(Char const* const pch) const& THROW(tc::csv_parse_exception) {
+				throw tc::csv_parse_exception{tc::explicit_cast<std::size_t>(pch - m_pchBegin)};
+			}
+
+			Char const* m_pchBegin;
+			Char const* m_pchEnd;
+			Char m_chDelimiter;
+			Char m_chQuote;
+
+			Char const* m_pchField;
+			bool m_bQuoted = false;
+			bool m_bEscaped = false;
+			bool m_bSkipQuote = false;
+			Char const* m_pchQuoteEnd = nullptr;
+			tc::vector<tc::csv_field<Char>> m_vecfield; // reused for all rows
+		};
+	}
+
+	namespace no_adl {
+		template<typename Rng>
+		struct [[nodiscard]] csv_rows_adaptor final : private tc::range_adaptor_base_range<Rng> {
+		private:
+			using char_t = tc::range_value_t<Rng>;
+			static_assert( tc::contiguous_range<Rng const&>, "fields refer to the input, which must be contiguous" );
+			tc::csv_options m_csvoptions;
+		public:
+			friend auto range_output_t_impl(csv_rows_adaptor const&) -> tc::type::list<tc::span<tc::csv_field<char_t> const> const&>; // declaration only
+
+			template<typename RngRef>
+			constexpr csv_rows_adaptor(RngRef&& rng, tc::csv_options const& csvoptions) noexcept
+				: tc::range_adaptor_base_range<Rng>(aggregate_tag, std::forward<RngRef>(rng))
+				, m_csvoptions(csvoptions)
+			{
+				_ASSERT( m_csvoptions.m_chDelimiter != m_csvoptions.m_chQuote );
+			}
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& THROW(tc::csv_parse_exception) {
+				using result_t = tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<tc::span<tc::csv_field<char_t> const> const&>())), tc::constant<tc::continue_>>;
+				char_t const* const pchBegin = tc::ptr_begin(this->base_range());
+				char_t const* const pchEnd = tc::ptr_end(this->base_range());
+				auto const chDelimiter = tc::explicit_cast<char_t>(m_csvoptions.m_chDelimiter);
+				auto const chQuote = tc::explicit_cast<char_t>(m_csvoptions.m_chQuote);
+				csv_detail::row_builder<char_t> rowbuilder(pchBegin, pchEnd, chDelimiter, chQuote);
+				auto const YieldRow = [&]() MAYTHROW -> result_t {
+					auto const rng = rowbuilder.row();
+					tc_yield(sink, rng); // MAYTHROW
+					rowbuilder.clear_row();
+					return tc::constant<tc::continue_>();
+				};
+
+				std::uint64_t nPrevInQuote = 0;
+				for( char_t const* pch = pchBegin; pch != pchEnd; ) {
+					std::size_t const n = tc::min(csv_detail::c_nBlockSize, tc::explicit_cast<std::size_t>(pchEnd - pch));
+					auto const masks = csv_detail::classify(pch, n, chDelimiter, chQuote);
+					std::uint64_t const nInQuote = tc::prefix_xor(masks.m_nQuote) ^ nPrevInQuote;
+					nPrevInQuote = 0 - (nInQuote >> 63);
+					for( std::uint64_t nStructural = masks.m_nQuote | ((masks.m_nDelimiter | masks.m_nLineFeed) & ~nInQuote); 0 != nStructural; nStructural &= nStructural - 1 ) {
+						auto const nIndex = tc::index_of_least_significant_bit(nStructural);
+						if( masks.m_nQuote >> nIndex & 1 ) {
+							rowbuilder.quote(pch + nIndex); // THROW(tc::csv_parse_exception)
+						} else if( masks.m_nDelimiter >> nIndex & 1 ) {
+							rowbuilder.end_field(pch + nIndex, /*bEndOfRow*/false); // THROW(tc::csv_parse_exception)
+						} else {
+							rowbuilder.end_field(pch + nIndex, /*bEndOfRow*/true); // THROW(tc::csv_parse_exception)
+							tc_return_if_break(YieldRow()) // MAYTHROW
+						}
+					}
+					pch += n;
+				}
+				if( rowbuilder.pending_row() ) { // no line feed after the last row
+					rowbuilder.end_field(pchEnd, /*bEndOfRow*/true); // THROW(tc::csv_parse_exception)
+					tc_return_if_break(YieldRow()) // MAYTHROW
+				}
+				return tc::implicit_cast<result_t>(tc::constant<tc::continue_>());
+			}
+		};
+	}
+	using no_adl::csv_rows_adaptor;
+
+	// Rows of rng, each a range of tc::csv_field. Rows end with LF or CRLF. Fields refer to rng, e.g., a tc::string or a mapped file,
+	// and the row range is only valid until the next row; parse numbers directly from csv_field::m_str, e.g., with
+	// tc::unsigned_integer_from_string_head. Iterating throws tc::csv_parse_exception on misplaced or unterminated quotes.
+	template<typename Rng>
+	auto csv_rows(Rng&& rng, tc::csv_options const& csvoptions = {}) return_ctor_noexcept(
+		csv_rows_adaptor<Rng>,
+		(std::forward<Rng>(rng), csvoptions)
+	)
+}
@@ -0,0 +1,113 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../container/string.h"
+#include "../range/repeat_n.h"
+#include "csv.h"
+
+#include <random>
+
+namespace {
+	template<typename Rng>
+	tc::vector<tc::vector<tc::string<char>>> rows(Rng const& rng, tc::csv_options const& csvoptions = {}) noexcept {
+		tc::vector<tc::vector<tc::string<char>>> vecvecstr;
+		tc::for_each(tc::csv_rows(rng, csvoptions), [&](auto const& rngfield) noexcept {
+			tc::vector<tc::string<char>> vecstr;
+			tc::for_each(rngfield, [&](tc::csv_field<char> const& field) noexcept {
+				tc::cont_emplace_back(vecstr, tc::make_str<char>(field));
+			});
+			tc::cont_emplace_back(vecvecstr, tc_move(vecstr));
+		});
+		return vecvecstr;
+	}
+
+	tc::vector<tc::vector<tc::string<char>>> table(std::initializer_list<std::initializer_list<char const*>> ilil) noexcept {
+		tc::vector<tc::vector<tc::string<char>>> vecvecstr;
+		for( auto const& il : ilil ) {
+			tc::vector<tc::string<char>> vecstr;
+			for( auto const sz : il ) tc::cont_emplace_back(vecstr, tc::string<char>(sz));
+			tc::cont_emplace_back(vecvecstr, tc_move(vecstr));
+		}
+		return vecvecstr;
+	}
+
+	template<typename Rng>
+	std::optional<std::size_t> parse_error(Rng const& rng) noexcept {
+		try {
+			tc::for_each(tc::csv_rows(rng), tc::noop());
+			return std::nullopt;
+		} catch( tc::csv_parse_exception const& e ) {
+			return e.m_nPosition;
+		}
+	}
+}
+
+UNITTESTDEF(csv_rows) {
+	_ASSERT( tc::empty(rows("")) );
+	_ASSERT( tc::equal(rows("a,b,c\n1,,3\n"), table({{"a", "b", "c"}, {"1", "", "3"}})) );
+	_ASSERT( tc::equal(rows("a,b\r\n1,2"), table({{"a", "b"}, {"1", "2"}})) );
+	_ASSERT( tc::equal(rows("\"a,b\",\"say \"\"hi\"\"\"\r\n\"line\nbreak\",\"\"\n"), table({{"a,b", "say \"hi\""}, {"line\nbreak", ""}})) );
+	_ASSERT( tc::equal(rows("a\n\nb"), table({{"a"}, {""}, {"b"}})) );
+	_ASSERT( tc::equal(rows("a\tb,c\n", tc::csv_options{'\t'}), table({{"a", "b,c"}})) );
+	_ASSERT( tc::equal(rows("'x;y';''''\n", tc::csv_options{';', '\''}), table({{"x;y", "'"}})) );
+
+	// fields refer to the input
+	tc::string<char> const str = "ab,\"c\"\"d\"";
+	tc::for_each(tc::csv_rows(str), [&](auto const& rngfield) noexcept {
+		_ASSERTEQUAL( tc::ptr_begin(tc::front(rngfield).m_str), tc::ptr_begin(str) );
+		_ASSERT( !tc::front(rngfield).m_bEscaped );
+		_ASSERT( tc::equal(tc::back(rngfield).m_str, "c\"\"d") );
+		_ASSERT( tc::back(rngfield).m_bEscaped );
+	});
+}
+
+UNITTESTDEF(csv_rows_errors) {
+	_ASSERTEQUAL( parse_error("a,b\"c\n"), 3 );
+	_ASSERTEQUAL( parse_error("\"ab\"c,d\n"), 4 );
+	_ASSERTEQUAL( parse_error("a,\"bc\n"), 2 );
+	_ASSERTEQUAL( parse_error("\"a\"\r,b"), 3 );
+	_ASSERT( !parse_error("\"a\"\r\n") );
+}
+
+UNITTESTDEF(csv_rows_block_boundaries) {
+	// Quoted fields with delimiters, line feeds and doubled quotes straddling the 64-character blocks.
+	std::mt19937 rng(11);
+	for( int nDocument = 0; nDocument < 30; ++nDocument ) {
+		tc::vector<tc::vector<tc::string<char>>> vecvecstr;
+		tc::string<char> strDocument;
+		for( int nRow = 0; nRow < 8; ++nRow ) {
+			tc::vector<tc::string<char>> vecstr;
+			for( int nField = 0; nField < 5; ++nField ) {
+				if( 0 < nField ) tc::append(strDocument, ",");
+				tc::string<char> strField;
+				for( unsigned int n = rng() % 12; 0 < n; --n ) tc::cont_emplace_back(strField, ",\n\"xyz"[rng() % 6]);
+				if( tc::find_first<tc::return_bool>(strField, ',') || tc::find_first<tc::return_bool>(strField, '\n') || tc::find_first<tc::return_bool>(strField, '"') ) {
+					tc::append(strDocument, "\"");
+					tc::for_each(strField, [&](char const ch) noexcept {
+						tc::append(strDocument, '"' == ch ? "\"\"" : tc::string<char>(1, ch));
+					});
+					tc::append(strDocument, "\"");
+				} else {
+					tc::append(strDocument, strField);
+				}
+				tc::cont_emplace_back(vecstr, tc_move(strField));
+			}
+			tc::append(strDocument, 0 == rng() % 2 ? "\n" : "\r\n");
+			tc::cont_emplace_back(vecvecstr, tc_move(vecstr));
+		}
+		for( std::size_t nOffset = 0; nOffset < 70; ++nOffset ) {
+			auto vecvecstrExpected = vecvecstr;
+			tc::vector<tc::string<char>> vecstrFirst(1, tc::string<char>(nOffset, 'p'));
+			vecvecstrExpected.insert(tc::begin(vecvecstrExpected), vecstrFirst);
+			_ASSERT( tc::equal(rows(tc::make_str<char>(tc::repeat_n(nOffset, 'p'), "\n", strDocument)), vecvecstrExpected) );
+		}
+	}
+}
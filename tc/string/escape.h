@@ -0,0 +1,381 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../algorithm/for_each.h"
+#include "../range/meta.h"
+#include "../range/range_adaptor.h"
+#include "../range/subrange.h"
+#include "convert_enc.h"
+
+#include <array>
+#include <string_view>
+
+// Escaping for XML text and attributes, JSON strings and RFC 3986 percent-encoding, and unescaping back, as generator ranges.
+// On contiguous input, the characters which need no escaping are skipped eight at a time with table lookups and passed to the sink
+// as one chunk. The escaping generators provide size(), which scans the input, so tc::append reserves the exact size.
+
+namespace tc {
+	// Thrown by the unescaping generators. m_nPosition is the index of the start of the invalid escape sequence.
+	struct unescape_exception final {
+		std::size_t m_nPosition;
+	};
+
+	namespace escape_detail {
+		template<typename Char>
+		constexpr unsigned int code(Char const ch) noexcept {
+			return static_cast<std::make_unsigned_t<Char>>(ch);
+		}
+
+		inline constexpr char c_achHexDigit[] = "0123456789ABCDEF";
+		inline constexpr std::size_t c_nMaxEscapeSize = 6;
+
+		constexpr std::size_t copy(std::string_view const str, char* const pch) noexcept {
+			for( std::size_t i = 0; i < str.size(); ++i ) pch[i] = str[i];
+			return str.size();
+		}
+
+		constexpr int hex_digit_value(unsigned int const n) noexcept {
+			return '0' <= n && n <= '9' ? static_cast<int>(n - '0')
+				: 'a' <= n && n <= 'f' ? static_cast<int>(n - 'a' + 10)
+				: 'A' <= n && n <= 'F' ? static_cast<int>(n - 'A' + 10)
+				: -1;
+		}
+
+		// Escaping policies: needs_escape for characters below 256, escape writes the escape sequence of such a character.
+		// Unescaping policies: unescape parses the escape sequence starting with c_chIntroducer and returns the end of the sequence,
+		// or null if it is invalid.
+
+		struct xml final {
+			static constexpr bool needs_escape(unsigned int const n) noexcept {
+				return '&' == n || '<' == n || '>' == n || '"' == n || '\'' == n;
+			}
+
+			static constexpr std::size_t escape(unsigned int const n, char* const pch) noexcept {
+				switch_no_default( n ) {
+					case '&': return copy("&amp;", pch);
+					case '<': return copy("&lt;", pch);
+					case '>': return copy("&gt;", pch);
+					case '"': return copy("&quot;", pch);
+					case '\'': return copy("&apos;", pch);
+				}
+			}
+
+			static constexpr char c_chIntroducer = '&';
+			static constexpr bool c_bCodePoint = true;
+
+			// Predefined entities and decimal and hexadecimal character references.
+			template<typename Char>
+			static Char const* unescape(Char const* pch, Char const* const pchEnd, unsigned int& nValue) noexcept {
+				_ASSERTEQUAL( code(*pch), '&' );
+				++pch;
+				auto const pchName = pch;
+				while( pch != pchEnd && ';' != code(*pch) ) {
+					if( pch - pchName == 8 ) return nullptr; // longest reference within the code point range is &#1114111;
+					++pch;
+				}
+				if( pch == pchEnd ) return nullptr;
+				auto const Is = [&](std::string_view const str) noexcept {
+					if( tc::explicit_cast<std::size_t>(pch - pchName) != str.size() ) return false;
+					for( std::size_t i = 0; i < str.size(); ++i ) {
+						if( code(pchName[i]) != static_cast<unsigned char>(str[i]) ) return false;
+					}
+					return true;
+				};
+				if( Is("amp") ) nValue = '&';
+				else if( Is("lt") ) nValue = '<';
+				else if( Is("gt") ) nValue = '>';
+				else if( Is("quot") ) nValue = '"';
+				else if( Is("apos") ) nValue = '\'';
+				else if( pchName != pch && '#' == code(*pchName) ) {
+					auto pchDigit = pchName + 1;
+					unsigned int const nBase = pchDigit != pch && ('x' == code(*pchDigit) || 'X' == code(*pchDigit)) ? (++pchDigit, 16) : 10;
+					if( pchDigit == pch ) return nullptr;
+					nValue = 0;
+					for( ; pchDigit != pch; ++pchDigit ) {
+						int const nDigit = hex_digit_value(code(*pchDigit));
+						if( nDigit < 0 || nBase <= tc::explicit_cast<unsigned int>(nDigit) ) return nullptr;
+						nValue = nValue * nBase + tc::explicit_cast<unsigned int>(nDigit);
+						if( 0x10ffff < nValue ) return nullptr;
+					}
+					if( 0 == nValue || (0xd800 <= nValue && nValue < 0xe000) ) return nullptr;
+				} else {
+					return nullptr;
+				}
+				return pch + 1;
+			}
+		};
+
+		struct json final {
+			static constexpr bool needs_escape(unsigned int const n) noexcept {
+				return '"' == n || '\\' == n || n < 0x20;
+			}
+
+			static constexpr std::size_t escape(unsigned int const n, char* const pch) noexcept {
+				switch( n ) {
+					case '"': return copy("\\\"", pch);
+					case '\\': return copy("\\\\", pch);
+					case '\b': return copy("\\b", pch);
+					case '\f': return copy("\\f", pch);
+					case '\n': return copy("\\n", pch);
+					case '\r': return copy("\\r", pch);
+					case '\t': return copy("\\t", pch);
+					default:
+						copy("\\u00", pch);
+						pch[4] = c_achHexDigit[n >> 4];
+						pch[5] = c_achHexDigit[n & 0xf];
+						return 6;
+				}
+			}
+
+			static constexpr char c_chIntroducer = '\\';
+			static constexpr bool c_bCodePoint = true;
+
+			template<typename Char>
+			static Char const* unescape_utf16(Char const* pch, Char const* const pchEnd, unsigned int& nValue) noexcept {
+				// pch points to the u of \uXXXX
+				if( pchEnd - pch < 5 ) return nullptr;
+				nValue = 0;
+				for( int i = 1; i <= 4; ++i ) {
+					int const nDigit = hex_digit_value(code(pch[i]));
+					if( nDigit < 0 ) return nullptr;
+					nValue = nValue * 16 + tc::explicit_cast<unsigned int>(nDigit);
+				}
+				return pch + 5;
+			}
+
+			template<typename Char>
+			static Char const* unescape(Char const* pch, Char const* const pchEnd, unsigned int& nValue) noexcept {
+				_ASSERTEQUAL( code(*pch), '\\' );
+				++pch;
+				if( pch == pchEnd ) return nullptr;
+				switch( code(*pch) ) {
+					case '"': nValue = '"'; return pch + 1;
+					case '\\': nValue = '\\'; return pch + 1;
+					case '/': nValue = '/'; return pch + 1;
+					case 'b': nValue = '\b'; return pch + 1;
+					case 'f': nValue = '\f'; return pch + 1;
+					case 'n': nValue = '\n'; return pch + 1;
+					case 'r': nValue = '\r'; return pch + 1;
+					case 't': nValue = '\t'; return pch + 1;
+					case 'u': {
+						pch = unescape_utf16(pch, pchEnd, nValue);
+						if( !pch || (0xdc00 <= nValue && nValue < 0xe000) ) return nullptr;
+						if( 0xd800 <= nValue && nValue < 0xdc00 ) { // surrogate pair
+							if( pchEnd - pch < 2 || '\\' != code(pch[0]) ) return nullptr;
+							unsigned int nTrailing;
+							pch = unescape_utf16(pch + 1, pchEnd, nTrailing);
+							if( !pch || nTrailing < 0xdc00 || 0xe000 <= nTrailing ) return nullptr;
+							nValue = 0x10000 + ((nValue - 0xd800) << 10) + (nTrailing - 0xdc00);
+						}
+						return pch;
+					}
+					default:
+						return nullptr;
+				}
+			}
+		};
+
+		struct percent final {
+			// RFC 3986 unreserved characters, like tc::rfc3986::is_unreserved
+			static constexpr bool needs_escape(unsigned int const n) noexcept {
+				return !(
+					('a' <= n && n <= 'z') || ('A' <= n && n <= 'Z') || ('0' <= n && n <= '9')
+					|| '-' == n || '.' == n || '_' == n || '~' == n
+				);
+			}
+
+			static constexpr std::size_t escape(unsigned int const n, char* const pch) noexcept {
+				pch[0] = '%';
+				pch[1] = c_achHexDigit[n >> 4];
+				pch[2] = c_achHexDigit[n & 0xf];
+				return 3;
+			}
+
+			static constexpr char c_chIntroducer = '%';
+			static constexpr bool c_bCodePoint = false;
+
+			template<typename Char>
+			static Char const* unescape(Char const* pch, Char const* const pchEnd, unsigned int& nValue) noexcept {
+				_ASSERTEQUAL( code(*pch), '%' );
+				if( pchEnd - pch < 3 ) return nullptr;
+				int const nHigh = hex_digit_value(code(pch[1]));
+				int const nLow = hex_digit_value(code(pch[2]));
+				if( nHigh < 0 || nLow < 0 ) return nullptr;
+				nValue = tc::explicit_cast<unsigned int>(nHigh * 16 + nLow);
+				return pch + 3;
+			}
+		};
+
+		template<typename Policy>
+		inline constexpr auto c_abNeedsEscape = []() noexcept {
+			std::array<bool, 256> ab{};
+			for( unsigned int n = 0; n < 256; ++n ) ab[n] = Policy::needs_escape(n);
+			return ab;
+		}();
+
+		// Characters above 255 only occur in wide strings and XML and JSON leave them as they are. Percent-encoding is byte-based.
+		template<typename Policy, typename Char>
+		constexpr bool needs_escape(Char const ch) noexcept {
+			auto const n = code(ch);
+			return n < 256 && c_abNeedsEscape<Policy>[n];
+		}
+
+		template<typename Policy>
+		constexpr std::size_t escaped_size(unsigned int const n) noexcept {
+			std::array<char, c_nMaxEscapeSize> ach{};
+			return Policy::escape(n, ach.data());
+		}
+
+		// First character in [pch, pchEnd) satisfying pred, where pred is a table lookup. Tests eight characters per iteration
+		// without branching on each of them.
+		template<typename Char, typename Pred>
+		Char const* find_first(Char const* pch, Char const* const pchEnd, Pred pred) noexcept {
+			for( ; 8 <= pchEnd - pch; pch += 8 ) {
+				if( pred(pch[0]) | pred(pch[1]) | pred(pch[2]) | pred(pch[3]) | pred(pch[4]) | pred(pch[5]) | pred(pch[6]) | pred(pch[7]) ) break;
+			}
+			while( pch != pchEnd && !pred(*pch) ) ++pch;
+			return pch;
+		}
+	}
+
+	namespace escape_adl {
+		template<typename Policy, typename Rng>
+		struct [[nodiscard]] escape_impl final : private tc::range_adaptor_base_range<Rng> {
+		private:
+			using char_t = tc::range_value_t<Rng>;
+		public:
+			friend auto range_output_t_impl(escape_impl const&) -> tc::type::list<char_t const&>; // declaration only
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<char_t const>>(), sink)), tc::constant<tc::continue_>>;
+				auto const Escape = [&](char_t const ch) MAYTHROW -> result_t {
+					std::array<char, escape_detail::c_nMaxEscapeSize> ach;
+					std::array<char_t, escape_detail::c_nMaxEscapeSize> achEscaped;
+					auto const n = Policy::escape(escape_detail::code(ch), ach.data());
+					for( std::size_t i = 0; i < n; ++i ) achEscaped[i] = static_cast<char_t>(ach[i]);
+					return tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(achEscaped.data(), achEscaped.data() + n), sink)); // MAYTHROW
+				};
+				if constexpr( tc::contiguous_range<Rng const&> ) {
+					char_t const* pch = tc::ptr_begin(this->base_range());
+					char_t const* const pchEnd = tc::ptr_end(this->base_range());
+					for(;;) {
+						auto const pchClean = pch;
+						pch = escape_detail::find_first(pch, pchEnd, [](char_t const ch) noexcept { return escape_detail::needs_escape<Policy>(ch); });
+						if( pchClean != pch ) {
+							tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(pchClean, pch), sink))) // MAYTHROW
+						}
+						if( pch == pchEnd ) return tc::implicit_cast<result_t>(tc::constant<tc::continue_>());
+						tc_return_if_break(Escape(*pch)) // MAYTHROW
+						++pch;
+					}
+				} else {
+					return tc::implicit_cast<result_t>(tc::for_each(this->base_range(), [&](char_t const ch) MAYTHROW -> result_t {
+						if( escape_detail::needs_escape<Policy>(ch) ) return Escape(ch); // MAYTHROW
+						return tc::implicit_cast<result_t>(tc::continue_if_not_break(sink, ch)); // MAYTHROW
+					}));
+				}
+			}
+
+			// Exact size of the output. Linear in the size of the input.
+			std::size_t size() const& noexcept {
+				std::size_t n = 0;
+				tc::for_each(this->base_range(), [&](char_t const ch) noexcept {
+					n += escape_detail::needs_escape<Policy>(ch) ? escape_detail::escaped_size<Policy>(escape_detail::code(ch)) : 1;
+				});
+				return n;
+			}
+		};
+
+		template<typename Policy, typename Rng>
+		struct [[nodiscard]] unescape_impl final : private tc::range_adaptor_base_range<Rng> {
+		private:
+			using char_t = tc::range_value_t<Rng>;
+			static_assert( tc::contiguous_range<Rng const&>, "unescaping looks ahead, so it is implemented for contiguous ranges only" );
+		public:
+			friend auto range_output_t_impl(unescape_impl const&) -> tc::type::list<char_t const&>; // declaration only
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& THROW(tc::unescape_exception) {
+				using result_t = tc::common_type_t<decltype(tc::for_each(std::declval<tc::span<char_t const>>(), sink)), tc::constant<tc::continue_>>;
+				char_t const* const pchBegin = tc::ptr_begin(this->base_range());
+				char_t const* const pchEnd = tc::ptr_end(this->base_range());
+				char_t const* pch = pchBegin;
+				for(;;) {
+					auto const pchClean = pch;
+					pch = escape_detail::find_first(pch, pchEnd, [](char_t const ch) noexcept { return escape_detail::code(ch) == static_cast<unsigned char>(Policy::c_chIntroducer); });
+					if( pchClean != pch ) {
+						tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(pchClean, pch), sink))) // MAYTHROW
+					}
+					if( pch == pchEnd ) return tc::implicit_cast<result_t>(tc::constant<tc::continue_>());
+
+					unsigned int nValue;
+					auto const pchNext = Policy::unescape(pch, pchEnd, nValue);
+					if( !pchNext ) throw tc::unescape_exception{tc::explicit_cast<std::size_t>(pch - pchBegin)};
+					std::array<char_t, 4> ach;
+					int n = 1;
+					if constexpr( Policy::c_bCodePoint ) {
+						n = tc::codepoint_codeunit_count<char_t>(nValue);
+						for( int i = 0; i < n; ++i ) ach[i] = tc::codepoint_codeunit_at<char_t>(nValue, i);
+					} else {
+						ach[0] = static_cast<char_t>(nValue);
+					}
+					tc_return_if_break(tc::implicit_cast<result_t>(tc::for_each(tc::make_iterator_range(ach.data(), ach.data() + n), sink))) // MAYTHROW
+					pch = pchNext;
+				}
+			}
+		};
+	}
+
+	// Escapes &, <, >, " and ' for XML text and attribute values.
+	template<typename Rng>
+	auto xml_escape(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(escape_adl::escape_impl<escape_detail::xml, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Escapes " and \ and control characters for the inside of a JSON string.
+	template<typename Rng>
+	auto json_escape(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(escape_adl::escape_impl<escape_detail::json, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Percent-encodes all bytes but the RFC 3986 unreserved characters, e.g., UTF-8 for a URI path segment or query value.
+	template<typename Rng> requires (1 == sizeof(tc::range_value_t<Rng>))
+	auto percent_encode(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(escape_adl::escape_impl<escape_detail::percent, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Replaces predefined entities and character references. Iterating throws tc::unescape_exception on invalid references.
+	template<typename Rng>
+	auto xml_unescape(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(escape_adl::unescape_impl<escape_detail::xml, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Replaces the escape sequences of a JSON string, including surrogate pairs. Iterating throws tc::unescape_exception on invalid sequences.
+	template<typename Rng>
+	auto json_unescape(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(escape_adl::unescape_impl<escape_detail::json, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Replaces %XX by the byte XX. Iterating throws tc::unescape_exception on invalid sequences.
+	template<typename Rng> requires (1 == sizeof(tc::range_value_t<Rng>))
+	auto percent_decode(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(escape_adl::unescape_impl<escape_detail::percent, Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+}
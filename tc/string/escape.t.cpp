@@ -0,0 +1,88 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../container/string.h"
+#include "../range/transform.h"
+#include "ascii.h"
+#include "escape.h"
+
+namespace {
+	template<typename Rng>
+	std::optional<std::size_t> unescape_error(Rng const& rng) noexcept {
+		try {
+			tc::for_each(rng, tc::noop());
+			return std::nullopt;
+		} catch( tc::unescape_exception const& e ) {
+			return e.m_nPosition;
+		}
+	}
+}
+
+UNITTESTDEF(escape_xml) {
+	_ASSERT( tc::equal(tc::make_str<char>(tc::xml_escape("")), "") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::xml_escape("a<b && c>'d'\"")), "a&lt;b &amp;&amp; c&gt;&apos;d&apos;&quot;") );
+	_ASSERT( tc::equal(tc::make_str<tc::char16>(tc::xml_escape(u"ä<€")), u"ä&lt;€") );
+	_ASSERTEQUAL( tc::size(tc::xml_escape("a<b && c>")), 23 );
+
+	_ASSERT( tc::equal(tc::make_str<char>(tc::xml_unescape("a&lt;b &amp;&amp; c&gt;&apos;&quot;")), "a<b && c>'\"") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::xml_unescape("&#65;&#x42;&#X43;&#xe4;")), "ABC\xc3\xa4") );
+	_ASSERT( tc::equal(tc::make_str<tc::char16>(tc::xml_unescape(u"&#x1F600;")), u"\U0001F600") );
+	_ASSERTEQUAL( unescape_error(tc::xml_unescape("ab&foo;")), 2 );
+	_ASSERTEQUAL( unescape_error(tc::xml_unescape("ab&amp")), 2 );
+	_ASSERTEQUAL( unescape_error(tc::xml_unescape("&#;")), 0 );
+	_ASSERTEQUAL( unescape_error(tc::xml_unescape("&#12a;")), 0 );
+	_ASSERTEQUAL( unescape_error(tc::xml_unescape("&#x110000;")), 0 );
+	_ASSERTEQUAL( unescape_error(tc::xml_unescape("&#xd800;")), 0 );
+}
+
+UNITTESTDEF(escape_json) {
+	_ASSERT( tc::equal(tc::make_str<char>(tc::json_escape("say \"hi\"\\\n\t\x01/")), "say \\\"hi\\\"\\\\\\n\\t\\u0001/") );
+	_ASSERTEQUAL( tc::size(tc::json_escape("\x1f\"")), 8 );
+
+	_ASSERT( tc::equal(tc::make_str<char>(tc::json_unescape("say \\\"hi\\\"\\\\\\n\\t\\u0001\\/")), "say \"hi\"\\\n\t\x01/") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::json_unescape("\\u00e4\\u20AC")), "\xc3\xa4\xe2\x82\xac") );
+	_ASSERT( tc::equal(tc::make_str<tc::char16>(tc::json_unescape(u"\\ud83d\\ude00!")), u"\U0001F600!") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::json_unescape("\\ud83d\\ude00")), "\xf0\x9f\x98\x80") );
+	_ASSERTEQUAL( unescape_error(tc::json_unescape("ab\\x")), 2 );
+	_ASSERTEQUAL( unescape_error(tc::json_unescape("ab\\")), 2 );
+	_ASSERTEQUAL( unescape_error(tc::json_unescape("\\u12")), 0 );
+	_ASSERTEQUAL( unescape_error(tc::json_unescape("\\ud83d")), 0 ); // lone leading surrogate
+	_ASSERTEQUAL( unescape_error(tc::json_unescape("\\ude00")), 0 ); // lone trailing surrogate
+	_ASSERTEQUAL( unescape_error(tc::json_unescape("\\ud83d\\u0041")), 0 );
+}
+
+UNITTESTDEF(escape_percent) {
+	for( unsigned int n = 0; n < 256; ++n ) {
+		_ASSERTEQUAL( tc::escape_detail::percent::needs_escape(n), !tc::rfc3986::is_unreserved(static_cast<char>(n)) );
+	}
+	_ASSERT( tc::equal(tc::make_str<char>(tc::percent_encode("a b/c~\xc3\xa4")), "a%20b%2Fc~%C3%A4") );
+	_ASSERTEQUAL( tc::size(tc::percent_encode("a b/c~\xc3\xa4")), 16 );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::percent_decode("a%20b%2fc~%C3%A4")), "a b/c~\xc3\xa4") );
+	_ASSERTEQUAL( unescape_error(tc::percent_decode("abc%2")), 3 );
+	_ASSERTEQUAL( unescape_error(tc::percent_decode("abc%g0")), 3 );
+}
+
+UNITTESTDEF(escape_roundtrip) {
+	// long clean runs, escapes at block boundaries and non-contiguous input
+	tc::string<char> str;
+	for( int i = 0; i < 300; ++i ) {
+		tc::cont_emplace_back(str, static_cast<char>(0 == i % 7 ? "<&\"\n\\ %"[i % 8] : 'a' + i % 26));
+	}
+	auto const Roundtrip = [&](auto fnEscape, auto fnUnescape) noexcept {
+		auto const strEscaped = tc::make_str<char>(fnEscape(str));
+		_ASSERTEQUAL( tc::size(fnEscape(str)), tc::size(strEscaped) );
+		_ASSERT( tc::equal(tc::make_str<char>(fnEscape(tc::transform(str, tc::fn_static_cast<char>()))), strEscaped) );
+		_ASSERT( tc::equal(tc::make_str<char>(fnUnescape(strEscaped)), str) );
+	};
+	Roundtrip(tc_fn(tc::xml_escape), tc_fn(tc::xml_unescape));
+	Roundtrip(tc_fn(tc::json_escape), tc_fn(tc::json_unescape));
+	Roundtrip(tc_fn(tc::percent_encode), tc_fn(tc::percent_decode));
+}
@@ -16,6 +16,7 @@
 #include "../range/subrange.h"
 #include "../range/concat_adaptor.h"
 #include "../range/repeat_n.h"
+#include "../container/container.h"
 #include "value_restrictive.h"
 
 #ifdef __clang__
@@ -27,6 +28,19 @@
 #pragma clang diagnostic pop
 #endif
 
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#ifndef __cpp_lib_to_chars
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+
 namespace tc {
 	///////////////
 	// Wrapper to print integers as decimal
@@ -97,6 +111,178 @@ namespace tc {
 		tc::as_padded_dec<N>(t.m_t)
 	)
 
+	namespace floating_point_charconv_detail {
+#ifdef __cpp_lib_to_chars
+		inline constexpr bool c_bFromChars = true;
+
+		template< typename T >
+		std::to_chars_result to_chars(char* const pchBegin, char* const pchEnd, T const t, int const nDecimals) noexcept {
+			return nDecimals < 0
+				? std::to_chars(pchBegin, pchEnd, t)
+				: std::to_chars(pchBegin, pchEnd, t, std::chars_format::fixed, nDecimals);
+		}
+
+		template< typename T >
+		std::from_chars_result from_chars(char const* const pchBegin, char const* const pchEnd, T& t) noexcept {
+			return std::from_chars(pchBegin, pchEnd, t, std::chars_format::general);
+		}
+#else
+		// Fallback for standard libraries without floating point std::to_chars and std::from_chars, e.g., libc++ of Xcode,
+		// using the C library without allocation. The locale only affects the decimal point, which is replaced by '.'
+		// when printing and avoided when parsing. The shortest representation is found by increasing the precision
+		// until the value reads back the same. It may have one digit more than that of std::to_chars.
+		inline constexpr bool c_bFromChars = false;
+
+		// Only parses numbers without decimal point as written by floating_point_from_string_head_detail::normalize.
+		template< typename T >
+		std::from_chars_result from_chars(char const* const pchBegin, char const* const pchEnd, T& t) noexcept {
+			std::array<char, 1024> ach;
+			auto const n = tc::min(tc::explicit_cast<std::size_t>(pchEnd - pchBegin), ach.size() - 1);
+			std::memcpy(ach.data(), pchBegin, n);
+			ach[n] = '\0';
+			char* pchParsed;
+			if constexpr( std::is_same<T, float>::value ) {
+				t = std::strtof(ach.data(), &pchParsed);
+			} else {
+				t = std::strtod(ach.data(), &pchParsed);
+			}
+			if( ach.data() == pchParsed ) return {pchBegin, std::errc::invalid_argument};
+			return {pchBegin + (pchParsed - ach.data()), std::errc()};
+		}
+
+		inline char* replace_decimal_point(char* const pchBegin, char* const pchEnd) noexcept {
+			char const* const pchPoint = std::localeconv()->decimal_point;
+			auto const nPoint = std::strlen(pchPoint);
+			if( 1 == nPoint && '.' == *pchPoint ) return pchEnd;
+			auto const pch = std::search(pchBegin, pchEnd, pchPoint, pchPoint + nPoint);
+			if( pch == pchEnd ) return pchEnd;
+			*pch = '.';
+			return std::copy(pch + nPoint, pchEnd, pch + 1);
+		}
+
+		template< typename T >
+		std::to_chars_result to_chars(char* const pchBegin, char* const pchEnd, T const t, int const nDecimals) noexcept {
+			std::array<char, 512> ach; // more than the 352 characters of as_fixed_dec(-DBL_MAX, 40) and a terminator
+			char* pch = ach.data();
+			auto const Print = [&](char const* const szFormat, int const nPrecision) noexcept {
+				auto const n = std::snprintf(ach.data(), ach.size(), szFormat, nPrecision, static_cast<double>(t));
+				return 0 <= n && tc::explicit_cast<std::size_t>(n) < ach.size() ? replace_decimal_point(ach.data(), ach.data() + n) : nullptr;
+			};
+			if( 0 <= nDecimals ) {
+				pch = Print("%.*f", nDecimals);
+			} else if( std::signbit(t) ) {
+				*pch++ = '-';
+			}
+			if( nDecimals < 0 && !std::isfinite(t) ) {
+				pch = std::copy_n(std::isnan(t) ? "nan" : "inf", 3, pch);
+			} else if( nDecimals < 0 && 0 == t ) {
+				*pch++ = '0';
+			} else if( nDecimals < 0 ) {
+				// Digits and decimal exponent of the fewest digits which read back as t.
+				std::array<char, std::numeric_limits<T>::max_digits10> achDigit;
+				std::size_t nDigits = 0;
+				int nExponent = 0;
+				for( int nPrecision = 1;; ++nPrecision ) {
+					auto const pchPrinted = Print("%.*e", nPrecision - 1);
+					_ASSERT( pchPrinted );
+					auto const pchExponent = std::find(ach.data(), pchPrinted, 'e');
+					nDigits = 0;
+					for( auto pchDigit = ach.data(); pchDigit != pchExponent; ++pchDigit ) {
+						if( '0' <= *pchDigit && *pchDigit <= '9' ) achDigit[nDigits++] = *pchDigit;
+					}
+					nExponent = std::atoi(pchExponent + 1);
+					if( std::numeric_limits<T>::max_digits10 == nPrecision ) break;
+					std::array<char, std::numeric_limits<T>::max_digits10 + 8> achNormalized;
+					auto pchNormalized = std::copy_n(achDigit.data(), nDigits, achNormalized.data());
+					*pchNormalized++ = 'e';
+					pchNormalized = std::to_chars(pchNormalized, achNormalized.data() + achNormalized.size(), nExponent - tc::explicit_cast<int>(nDigits) + 1).ptr;
+					T tRead;
+					from_chars(achNormalized.data(), pchNormalized, tRead);
+					if( std::abs(t) == tRead ) break;
+				}
+				// Fixed or scientific notation, whichever is shorter, preferring fixed like std::to_chars.
+				auto const n = tc::explicit_cast<int>(nDigits);
+				int const nFixed = nExponent < 0 ? n + 1 - nExponent : (n - 1 <= nExponent ? nExponent + 1 : n + 1);
+				int const nScientific = n + (1 < n ? 1 : 0) + 2 + (100 <= std::abs(nExponent) ? 3 : 2);
+				char const* const pchDigit = achDigit.data();
+				if( nFixed <= nScientific ) {
+					if( nExponent < 0 ) {
+						*pch++ = '0';
+						*pch++ = '.';
+						pch = std::fill_n(pch, -nExponent - 1, '0');
+						pch = std::copy_n(pchDigit, n, pch);
+					} else if( n - 1 <= nExponent ) {
+						pch = Print("%.*f", 0); // the exact integer, like std::to_chars
+					} else {
+						pch = std::copy_n(pchDigit, nExponent + 1, pch);
+						*pch++ = '.';
+						pch = std::copy(pchDigit + nExponent + 1, pchDigit + n, pch);
+					}
+				} else {
+					*pch++ = *pchDigit;
+					if( 1 < n ) {
+						*pch++ = '.';
+						pch = std::copy(pchDigit + 1, pchDigit + n, pch);
+					}
+					*pch++ = 'e';
+					*pch++ = nExponent < 0 ? '-' : '+';
+					if( std::abs(nExponent) < 10 ) *pch++ = '0';
+					pch = std::to_chars(pch, ach.data() + ach.size(), std::abs(nExponent)).ptr;
+				}
+			}
+			if( !pch || pchEnd - pchBegin < pch - ach.data() ) return {pchEnd, std::errc::value_too_large};
+			return {std::copy(ach.data(), pch, pchBegin), std::errc()};
+		}
+#endif
+	}
+
+	///////////////
+	// Wrapper to print floating point numbers as decimal
+
+	namespace floating_point_as_dec_adl {
+		inline constexpr int c_nMaxDecimals = 40;
+
+		// Without decimals, prints the shortest representation that reads back as the same value, in fixed or scientific notation,
+		// whichever is shorter. With decimals, prints fixed notation with that many digits after the decimal point.
+		// Uses std::to_chars where available, so the output does not depend on the locale and nothing is allocated. NaN and infinity
+		// print as nan and inf.
+		template< typename T >
+		struct [[nodiscard]] floating_point_as_dec_impl final {
+			friend auto range_output_t_impl(floating_point_as_dec_impl const&) -> tc::type::list<tc::char_ascii const&>; // declaration only
+		private:
+			T m_t;
+			int m_nDecimals; // negative for the shortest round trip representation
+		public:
+			constexpr floating_point_as_dec_impl(T t, int nDecimals) noexcept : m_t(t), m_nDecimals(nDecimals) {
+				_ASSERT( m_nDecimals <= c_nMaxDecimals );
+			}
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& MAYTHROW {
+				// sign, all integer digits of the largest finite value, decimal point and decimals
+				std::array<char, 1 + std::numeric_limits<T>::max_exponent10 + 1 + 1 + c_nMaxDecimals> ach;
+				auto const result = floating_point_charconv_detail::to_chars(ach.data(), ach.data() + ach.size(), m_t, m_nDecimals);
+				_ASSERT( std::errc() == result.ec );
+				std::array<tc::char_ascii, std::tuple_size<decltype(ach)>::value> achascii;
+				auto const n = std::errc() == result.ec ? result.ptr - ach.data() : 0; // more than c_nMaxDecimals, the contents of ach are unspecified
+				for( std::ptrdiff_t i = 0; i < n; ++i ) achascii[i] = tc::char_ascii(ach[i]);
+				return tc::for_each(tc::make_iterator_range(achascii.data(), achascii.data() + n), sink); // MAYTHROW
+			}
+		};
+	}
+
+	template< typename T > requires std::is_same<T, float>::value || std::is_same<T, double>::value
+	constexpr auto as_dec(T t) return_ctor_noexcept(
+		floating_point_as_dec_adl::floating_point_as_dec_impl<T>,
+		(t, -1)
+	)
+
+	template< typename T > requires std::is_same<T, float>::value || std::is_same<T, double>::value
+	constexpr auto as_fixed_dec(T t, int nDecimals) return_ctor_noexcept(
+		floating_point_as_dec_adl::floating_point_as_dec_impl<T>,
+		(t, (_ASSERT(0 <= nDecimals), nDecimals))
+	)
+
 	TC_DEFINE_ENUM(casing, BOOST_PP_EMPTY(), (uppercase)(lowercase));
 
 	namespace as_hex_adl {
@@ -199,6 +385,220 @@ MODIFY_WARNINGS_END
 		return pairnit;
 	}
 
+	namespace floating_point_from_string_head_detail {
+		// std::from_chars leaves the value alone if it is out of range. Like strtod, we return infinity on overflow and zero on underflow,
+		// and tell them apart by the decimal exponent of the first significant digit.
+		inline bool is_overflow(char const* pch, char const* const pchEnd) noexcept {
+			long nExponent = 0;
+			bool bLeadingZero = true;
+			bool bFraction = false;
+			for( ; pch != pchEnd && 'e' != *pch && 'E' != *pch; ++pch ) {
+				if( '.' == *pch ) {
+					bFraction = true;
+				} else if( bLeadingZero && '0' == *pch ) {
+					if( bFraction ) --nExponent;
+				} else if( '0' <= *pch && *pch <= '9' ) {
+					bLeadingZero = false;
+					if( !bFraction ) ++nExponent;
+				}
+			}
+			if( pch != pchEnd ) {
+				nExponent += tc::signed_integer_from_string_head<long>(tc::make_iterator_range(pch + 1, pchEnd)).first;
+			}
+			return 0 < nExponent;
+		}
+
+		template< typename T >
+		std::ptrdiff_t from_chars(char const* const pchBegin, char const* const pchEnd, T& t) noexcept {
+			auto pch = pchBegin;
+			if( pch != pchEnd && '+' == *pch ) { // std::from_chars does not accept a plus sign, signed_integer_from_string_head does.
+				++pch;
+				if( pch != pchEnd && '-' == *pch ) return 0;
+			}
+			auto const result = floating_point_charconv_detail::from_chars(pch, pchEnd, t);
+			if( std::errc::invalid_argument == result.ec ) return 0;
+			if( std::errc::result_out_of_range == result.ec ) {
+				t = is_overflow(pch, result.ptr) ? std::numeric_limits<T>::infinity() : T(0);
+				if( '-' == *pch ) t = -t;
+			}
+			return result.ptr - pchBegin;
+		}
+
+		// Halfway points between adjacent doubles have at most 767 significant decimal digits. Of further digits, only whether
+		// any of them is nonzero matters for rounding, which a trailing 1 keeps.
+		inline constexpr std::size_t c_nMaxDigits = 768;
+		// With at most c_nMaxDigits + 1 digits, larger decimal exponents give infinity or zero.
+		inline constexpr std::int64_t c_nMaxExponent = 100000;
+
+		// Number of the form [-]digits[e[-]exponent] without leading zeros, or [-]inf or [-]nan.
+		struct normalized_number final {
+			std::array<char, 1 + c_nMaxDigits + 1 + 8 + 1> m_ach; // sign, digits, sticky digit, at most e-100000, terminator
+			std::size_t m_n = 0;
+			std::size_t m_nConsumed = 0; // characters of the input, zero if it does not start with a number
+
+			void append(char const ch) & noexcept {
+				m_ach[m_n] = ch;
+				++m_n;
+			}
+		};
+
+		// ASCII character at it, or '\0'.
+		template< typename It, typename ItEnd >
+		char ascii_at(It const& it, ItEnd const& itEnd) noexcept {
+			if( it == itEnd ) return '\0';
+			auto const& ch = *it;
+			return tc::char_ascii('\0') <= ch && ch <= tc::char_ascii('\x7f') ? static_cast<char>(ch) : '\0';
+		}
+
+		inline bool is_digit(char const ch) noexcept {
+			return '0' <= ch && ch <= '9';
+		}
+
+		// Reads the longest prefix of [it, itEnd) that std::from_chars with std::chars_format::general accepts, after an optional plus sign,
+		// and stops at the first character which cannot continue it. The normalized number has the same value.
+		template< typename It, typename ItEnd >
+		normalized_number normalize(It it, ItEnd const& itEnd) noexcept {
+			normalized_number nn;
+			std::size_t nConsumed = 0;
+			auto const Skip = [&](std::size_t const n) noexcept {
+				for( std::size_t i = 0; i < n; ++i ) ++it;
+				nConsumed += n;
+			};
+			if( '+' == ascii_at(it, itEnd) ) {
+				Skip(1);
+				if( '-' == ascii_at(it, itEnd) ) return nn;
+			} else if( '-' == ascii_at(it, itEnd) ) {
+				nn.append('-');
+				Skip(1);
+			}
+
+			// Number of leading characters equal to the lower case literal sz up to case.
+			auto const Match = [&](char const* const sz) noexcept {
+				auto itLiteral = it;
+				std::size_t n = 0;
+				for( ; '\0' != sz[n] && sz[n] == (ascii_at(itLiteral, itEnd) | 0x20); ++n ) ++itLiteral;
+				return n;
+			};
+			auto const Literal = [&](char const* const sz, std::size_t const n) noexcept {
+				for( auto pch = sz; '\0' != *pch; ++pch ) nn.append(*pch);
+				Skip(n);
+				nn.m_nConsumed = nConsumed;
+				return nn;
+			};
+			if( auto const n = Match("infinity"); 3 <= n ) {
+				return Literal("inf", 8 == n ? 8 : 3);
+			}
+			if( 3 == Match("nan") ) {
+				// nan(n-char-sequence)
+				auto itParen = it;
+				std::size_t n = 3;
+				for( int i = 0; i < 3; ++i ) ++itParen;
+				if( '(' == ascii_at(itParen, itEnd) ) {
+					for( std::size_t nParen = 1;; ++nParen ) {
+						++itParen;
+						auto const ch = ascii_at(itParen, itEnd);
+						if( ')' == ch ) {
+							n += nParen + 1;
+							break;
+						}
+						if( !is_digit(ch) && !('a' <= (ch | 0x20) && (ch | 0x20) <= 'z') && '_' != ch ) break;
+					}
+				}
+				return Literal("nan", n);
+			}
+
+			std::int64_t nExponent = 0;
+			std::size_t nDigits = 0;
+			bool bDigit = false; // including leading zeros
+			bool bSticky = false;
+			auto const Digit = [&](char const ch, bool const bFraction) noexcept {
+				bDigit = true;
+				if( 0 == nDigits && '0' == ch ) {
+					if( bFraction ) --nExponent;
+				} else if( nDigits < c_nMaxDigits ) {
+					nn.append(ch);
+					++nDigits;
+					if( bFraction ) --nExponent;
+				} else {
+					if( !bFraction ) ++nExponent;
+					if( '0' != ch ) bSticky = true;
+				}
+			};
+			for( char ch; is_digit(ch = ascii_at(it, itEnd)); Skip(1) ) Digit(ch, /*bFraction*/false);
+			if( '.' == ascii_at(it, itEnd) ) {
+				auto itNext = it;
+				++itNext;
+				if( bDigit || is_digit(ascii_at(itNext, itEnd)) ) {
+					Skip(1);
+					for( char ch; is_digit(ch = ascii_at(it, itEnd)); Skip(1) ) Digit(ch, /*bFraction*/true);
+				}
+			}
+			if( !bDigit ) return nn;
+			if( bSticky ) {
+				nn.append('1');
+				--nExponent;
+			} else if( 0 == nDigits ) {
+				nn.append('0');
+				nExponent = 0;
+			}
+
+			// The exponent is only part of the number if it has digits.
+			if( 'e' == (ascii_at(it, itEnd) | 0x20) ) {
+				auto itExponent = it;
+				++itExponent;
+				std::size_t n = 1;
+				bool bNegative = false;
+				if( auto const ch = ascii_at(itExponent, itEnd); '+' == ch || '-' == ch ) {
+					bNegative = '-' == ch;
+					++itExponent;
+					++n;
+				}
+				if( is_digit(ascii_at(itExponent, itEnd)) ) {
+					std::int64_t nExponentExplicit = 0;
+					for( char ch; is_digit(ch = ascii_at(itExponent, itEnd)); ++itExponent, ++n ) {
+						if( nExponentExplicit < std::numeric_limits<std::int64_t>::max() / 100 ) nExponentExplicit = nExponentExplicit * 10 + (ch - '0');
+					}
+					nExponent += bNegative ? -nExponentExplicit : nExponentExplicit;
+					it = itExponent;
+					nConsumed += n;
+				}
+			}
+			if( 0 != nExponent ) {
+				nn.append('e');
+				auto const result = std::to_chars(nn.m_ach.data() + nn.m_n, nn.m_ach.data() + nn.m_ach.size(), tc::max(-c_nMaxExponent, tc::min(nExponent, c_nMaxExponent)));
+				_ASSERT( std::errc() == result.ec );
+				nn.m_n = tc::explicit_cast<std::size_t>(result.ptr - nn.m_ach.data());
+			}
+			nn.m_nConsumed = nConsumed;
+			return nn;
+		}
+	}
+
+	// Locale-independent and correctly rounded. Accepts an optional sign, fixed and scientific notation, inf, infinity and nan,
+	// but neither leading whitespace nor hexadecimal floating point. Returns zero and the begin iterator if no number was found.
+	// std::from_chars implements Eisel-Lemire with an exact fallback in current standard libraries. Without it, numbers are normalized
+	// and read by strtod (see floating_point_charconv_detail).
+	template< typename T, typename Rng > requires std::is_same<T, float>::value || std::is_same<T, double>::value
+	auto floating_point_from_string_head(Rng&& rng) noexcept {
+		auto pairtit = std::make_pair(T(0), tc::begin(rng));
+		if constexpr( floating_point_charconv_detail::c_bFromChars && tc::contiguous_range<Rng> && std::is_same<std::remove_cv_t<tc::range_value_t<Rng>>, char>::value ) {
+			pairtit.second += floating_point_from_string_head_detail::from_chars(tc::ptr_begin(rng), tc::ptr_end(rng), pairtit.first);
+		} else {
+			// Copy the number in normalized form to a buffer of char, which fits on the stack however long the number is.
+			auto const nn = floating_point_from_string_head_detail::normalize(pairtit.second, tc::end(rng));
+			if( 0 < nn.m_nConsumed ) {
+				VERIFYEQUAL( floating_point_from_string_head_detail::from_chars(nn.m_ach.data(), nn.m_ach.data() + nn.m_n, pairtit.first), tc::explicit_cast<std::ptrdiff_t>(nn.m_n) );
+				std::advance(pairtit.second, nn.m_nConsumed);
+			}
+		}
+		return pairtit;
+	}
+
+	template< typename Rng >
+	auto double_from_string_head(Rng&& rng) return_decltype_noexcept(
+		tc::floating_point_from_string_head<double>(std::forward<Rng>(rng))
+	)
+
 	struct integer_parse_exception final {};
 
 	template< typename T, typename Rng >
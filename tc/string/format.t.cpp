@@ -0,0 +1,91 @@
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../container/string.h"
+#include "format.h"
+
+#include <cmath>
+#include <random>
+
+UNITTESTDEF(floating_point_as_dec) {
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(0.1)), "0.1") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(-2.5)), "-2.5") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(100.0)), "100") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(1e21)), "1e+21") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(0.1f)), "0.1") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(std::numeric_limits<double>::infinity())), "inf") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_dec(-std::numeric_limits<double>::max())), "-1.7976931348623157e+308") );
+
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_fixed_dec(2.0 / 3, 3)), "0.667") );
+	_ASSERT( tc::equal(tc::make_str<char>(tc::as_fixed_dec(2.5, 0)), "2") ); // round half to even
+	_ASSERTEQUAL( tc::size(tc::make_str<char>(tc::as_fixed_dec(-std::numeric_limits<double>::max(), tc::floating_point_as_dec_adl::c_nMaxDecimals))), 1 + 309 + 1 + tc::floating_point_as_dec_adl::c_nMaxDecimals );
+
+	_ASSERT( tc::equal(tc::make_str<char>("x=", tc::as_dec(1.5), ", n=", tc::as_dec(3)), "x=1.5, n=3") );
+}
+
+UNITTESTDEF(floating_point_from_string_head) {
+	auto const Parse = [](auto const& str) noexcept {
+		auto const pairdit = tc::double_from_string_head(str);
+		return std::make_pair(pairdit.first, pairdit.second - tc::begin(str));
+	};
+	_ASSERTEQUAL( Parse("0.1"), std::make_pair(0.1, std::ptrdiff_t(3)) );
+	_ASSERTEQUAL( Parse("-12.5e2xyz"), std::make_pair(-1250.0, std::ptrdiff_t(7)) );
+	_ASSERTEQUAL( Parse("+7"), std::make_pair(7.0, std::ptrdiff_t(2)) );
+	_ASSERTEQUAL( Parse("1e"), std::make_pair(1.0, std::ptrdiff_t(1)) );
+	_ASSERTEQUAL( Parse("abc"), std::make_pair(0.0, std::ptrdiff_t(0)) );
+	_ASSERTEQUAL( Parse("+-1"), std::make_pair(0.0, std::ptrdiff_t(0)) );
+	_ASSERTEQUAL( Parse(""), std::make_pair(0.0, std::ptrdiff_t(0)) );
+	_ASSERTEQUAL( Parse("1e999"), std::make_pair(std::numeric_limits<double>::infinity(), std::ptrdiff_t(5)) );
+	_ASSERTEQUAL( Parse("-1e999"), std::make_pair(-std::numeric_limits<double>::infinity(), std::ptrdiff_t(6)) );
+	_ASSERTEQUAL( Parse("1e-999"), std::make_pair(0.0, std::ptrdiff_t(6)) );
+	_ASSERTEQUAL( Parse("0.00001e-320"), std::make_pair(0.0, std::ptrdiff_t(12)) );
+	_ASSERTEQUAL( Parse(u"-12.5e2xyz"), std::make_pair(-1250.0, std::ptrdiff_t(7)) );
+	_ASSERTEQUAL( Parse(tc::make_str<tc::char16>(u"0.", tc::repeat_n(100, u'0'), u"1")), std::make_pair(1e-101, std::ptrdiff_t(103)) );
+	_ASSERT( std::isnan(tc::double_from_string_head("nan").first) );
+
+	// Non-contiguous input is normalized onto the stack, and must parse like the contiguous input read by std::from_chars.
+	auto const ParseWide = [&](auto const& str) noexcept {
+		return Parse(tc::transform(str, [](char const ch) noexcept { return static_cast<tc::char16>(ch); }));
+	};
+	for( auto const& str : {
+		"0.1", "-12.5e2xyz", "+7", "1e", "1e+", "1E-2", "abc", "+-1", "-", ".", ".5", "5.", "-.5e1", "00012.3400", "-0", "0.000",
+		"inf", "-Infinity", "infinit", "nan", "NaN(abc_1)", "nan(", "nan()", "1e999", "-1e-999", "123456789012345678901234567890"
+	} ) {
+		auto const pairdn = Parse(tc::make_str<char>(str));
+		auto const pairdnWide = ParseWide(tc::make_str<char>(str));
+		_ASSERTEQUAL( pairdnWide.second, pairdn.second );
+		_ASSERT( pairdnWide.first == pairdn.first || (std::isnan(pairdnWide.first) && std::isnan(pairdn.first)) );
+		_ASSERTEQUAL( std::signbit(pairdnWide.first), std::signbit(pairdn.first) );
+	}
+
+	// A number followed by a long word is read up to the word.
+	_ASSERTEQUAL( ParseWide(tc::make_str<char>("2.5", tc::repeat_n(100, 'x'))), std::make_pair(2.5, std::ptrdiff_t(3)) );
+	_ASSERTEQUAL( ParseWide(tc::make_str<char>("1", tc::repeat_n(1000, '0'), "e-1000")), std::make_pair(1.0, std::ptrdiff_t(1007)) );
+
+	// 1 + 2^-53 is halfway between 1 and the next double and rounds to even. Any nonzero digit after it rounds up,
+	// even far beyond the digits kept.
+	auto const strHalfway = tc::make_str<char>("1.00000000000000011102230246251565404236316680908203125", tc::repeat_n(1000, '0'));
+	_ASSERTEQUAL( ParseWide(strHalfway).first, 1.0 );
+	_ASSERTEQUAL( ParseWide(tc::make_str<char>(strHalfway, "1")).first, std::nextafter(1.0, 2.0) );
+	_ASSERTEQUAL( Parse(tc::make_str<char>(strHalfway, "1")).first, std::nextafter(1.0, 2.0) );
+
+	// round trip
+	std::mt19937_64 rng(42);
+	for( int i = 0; i < 1000; ++i ) {
+		double const d = tc::bit_cast<double>(rng());
+		if( std::isnan(d) ) continue;
+		auto const str = tc::make_str<char>(tc::as_dec(d));
+		auto const pairdit = tc::double_from_string_head(str);
+		_ASSERTEQUAL( pairdit.first, d );
+		_ASSERT( tc::end(str) == pairdit.second );
+		auto const f = static_cast<float>(d);
+		_ASSERTEQUAL( tc::floating_point_from_string_head<float>(tc::make_str<char>(tc::as_dec(f))).first, f );
+	}
+}
@@ -0,0 +1,444 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../base/assert_defs.h"
+#include "../base/bitfield.h"
+#include "../base/enum.h"
+#include "../algorithm/algorithm.h"
+#include "../algorithm/empty.h"
+#include "../algorithm/for_each.h"
+#include "../algorithm/find.h"
+#include "../container/container.h"
+#include "../range/range_adaptor.h"
+#include "../range/subrange.h"
+#include "escape.h"
+#include "format.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Streaming JSON (RFC 8259) tokenizer and writer.
+//
+// tc::json_tokens works in two stages, like simdjson. The first stage classifies 64 bytes at a time into bit masks of quotes,
+// backslashes, operators and whitespace and derives with bit arithmetic which quotes are escaped, which bytes are inside strings
+// and where tokens start. The second stage visits only these structural positions, checks the grammar and yields tokens which
+// refer to the input without copying. The masks are computed with portable integer code; no instruction set specific intrinsics.
+
+namespace tc {
+	// Thrown while iterating tc::json_tokens. m_nPosition is the index of the offending character, or the size of the input
+	// if the document ends early.
+	struct json_parse_exception final {
+		std::size_t m_nPosition;
+	};
+
+	TC_DEFINE_ENUM(EJsonToken, ejsontoken, (BEGINOBJECT)(ENDOBJECT)(BEGINARRAY)(ENDARRAY)(KEY)(STRING)(NUMBER)(TRUELITERAL)(FALSELITERAL)(NULLLITERAL))
+
+	template<typename Char>
+	struct json_token final {
+		tc::EJsonToken m_ejsontoken;
+		// KEY and STRING: the characters between the quotes, still escaped if m_bEscaped; read them with tc::json_unescape.
+		// NUMBER: the number, e.g., for tc::double_from_string_head. Other tokens: their characters.
+		tc::span<Char const> m_str;
+		bool m_bEscaped;
+	};
+
+	namespace json_detail {
+		inline constexpr unsigned char c_nClassQuote = 1;
+		inline constexpr unsigned char c_nClassBackslash = 2;
+		inline constexpr unsigned char c_nClassOperator = 4;
+		inline constexpr unsigned char c_nClassWhitespace = 8;
+		inline constexpr unsigned char c_nClassControl = 16;
+
+		inline constexpr auto c_anClass = []() noexcept {
+			std::array<unsigned char, 256> an{};
+			for( unsigned int n = 0; n < 0x20; ++n ) an[n] = c_nClassControl;
+			an['"'] = c_nClassQuote;
+			an['\\'] = c_nClassBackslash;
+			for( char const ch : std::string_view("{}[]:,") ) an[static_cast<unsigned char>(ch)] = c_nClassOperator;
+			for( char const ch : std::string_view(" \t\n\r") ) an[static_cast<unsigned char>(ch)] |= c_nClassWhitespace; // tab, line feed and carriage return are control characters, too
+			return an;
+		}();
+
+		inline constexpr std::size_t c_nBlockSize = 64;
+
+		struct block_masks final {
+			std::uint64_t m_nQuote = 0;
+			std::uint64_t m_nBackslash = 0;
+			std::uint64_t m_nOperator = 0;
+			std::uint64_t m_nWhitespace = 0;
+			std::uint64_t m_nControl = 0;
+		};
+
+		inline block_masks classify(unsigned char const* const pb) noexcept {
+			block_masks masks;
+			for( std::size_t i = 0; i < c_nBlockSize; ++i ) {
+				std::uint64_t const n = c_anClass[pb[i]];
+				masks.m_nQuote |= (n & 1) << i;
+				masks.m_nBackslash |= (n >> 1 & 1) << i;
+				masks.m_nOperator |= (n >> 2 & 1) << i;
+				masks.m_nWhitespace |= (n >> 3 & 1) << i;
+				masks.m_nControl |= (n >> 4 & 1) << i;
+			}
+			return masks;
+		}
+
+		// First stage. Carries the state at the end of a block into the next one.
+		struct structural_indexer final {
+			// Returns the positions of operators, opening and closing quotes, starts of numbers and literals,
+			// and control characters inside strings, which are errors.
+			std::uint64_t next(block_masks const& masks) & noexcept {
+				// A character is escaped if it follows an odd-length run of backslashes. Runs are told apart by whether they
+				// start on an even or odd bit: adding the run starts to the backslashes carries through each run.
+				constexpr std::uint64_t c_nEvenBits = 0x5555555555555555;
+				std::uint64_t const nBackslash = masks.m_nBackslash & ~m_nPrevEscaped;
+				std::uint64_t const nFollowsEscape = nBackslash << 1 | m_nPrevEscaped;
+				std::uint64_t const nOddSequenceStarts = nBackslash & ~c_nEvenBits & ~nFollowsEscape;
+				std::uint64_t const nSequencesStartingOnEvenBits = nOddSequenceStarts + nBackslash;
+				m_nPrevEscaped = nSequencesStartingOnEvenBits < nOddSequenceStarts ? 1 : 0; // carry
+				std::uint64_t const nEscaped = (c_nEvenBits ^ (nSequencesStartingOnEvenBits << 1)) & nFollowsEscape;
+
+				std::uint64_t const nQuote = masks.m_nQuote & ~nEscaped;
+				// From each opening quote up to, but excluding, the closing quote.
+				std::uint64_t const nInString = tc::prefix_xor(nQuote) ^ m_nPrevInString;
+				m_nPrevInString = 0 - (nInString >> 63);
+				// The characters of strings after the opening quote, including the closing quote.
+				std::uint64_t const nStringTail = nInString ^ nQuote;
+
+				std::uint64_t const nScalar = ~(masks.m_nOperator | masks.m_nWhitespace);
+				std::uint64_t const nNonQuoteScalar = nScalar & ~nQuote;
+				std::uint64_t const nFollowsNonQuoteScalar = nNonQuoteScalar << 1 | m_nPrevScalar;
+				m_nPrevScalar = nNonQuoteScalar >> 63;
+
+				return ((masks.m_nOperator | (nScalar & ~nFollowsNonQuoteScalar)) & ~nStringTail)
+					| (nQuote & nStringTail)
+					| (masks.m_nControl & nStringTail);
+			}
+
+		private:
+			std::uint64_t m_nPrevEscaped = 0;
+			std::uint64_t m_nPrevInString = 0;
+			std::uint64_t m_nPrevScalar = 0;
+		};
+
+		template<typename Char>
+		constexpr unsigned int code(Char const ch) noexcept {
+			return static_cast<unsigned char>(ch);
+		}
+
+		template<typename Char>
+		constexpr bool is_digit(Char const* const pch, Char const* const pchEnd) noexcept {
+			return pch != pchEnd && '0' <= code(*pch) && code(*pch) <= '9';
+		}
+
+		// End of the number starting at pch, or null if there is no valid number.
+		template<typename Char>
+		Char const* parse_number(Char const* pch, Char const* const pchEnd) noexcept {
+			if( pch != pchEnd && '-' == code(*pch) ) ++pch;
+			if( !is_digit(pch, pchEnd) ) return nullptr;
+			if( '0' == code(*pch) ) {
+				++pch;
+			} else {
+				while( is_digit(pch, pchEnd) ) ++pch;
+			}
+			if( pch != pchEnd && '.' == code(*pch) ) {
+				++pch;
+				if( !is_digit(pch, pchEnd) ) return nullptr;
+				while( is_digit(pch, pchEnd) ) ++pch;
+			}
+			if( pch != pchEnd && ('e' == code(*pch) || 'E' == code(*pch)) ) {
+				++pch;
+				if( pch != pchEnd && ('+' == code(*pch) || '-' == code(*pch)) ) ++pch;
+				if( !is_digit(pch, pchEnd) ) return nullptr;
+				while( is_digit(pch, pchEnd) ) ++pch;
+			}
+			return pch;
+		}
+
+		template<typename Char>
+		Char const* parse_literal(Char const* const pch, Char const* const pchEnd, std::string_view const str) noexcept {
+			if( tc::explicit_cast<std::size_t>(pchEnd - pch) < str.size() ) return nullptr;
+			for( std::size_t i = 0; i < str.size(); ++i ) {
+				if( code(pch[i]) != static_cast<unsigned char>(str[i]) ) return nullptr;
+			}
+			return pch + str.size();
+		}
+
+		TC_DEFINE_ENUM(EExpect, eexpect, (VALUE)(VALUEORENDARRAY)(KEYORENDOBJECT)(KEY)(COLON)(COMMAOREND)(DONE))
+
+		// Second stage. Checks the grammar at the structural positions in order and produces the tokens.
+		template<typename Char>
+		struct tokenizer final {
+			tokenizer(Char const* const pchBegin, Char const* const pchEnd) noexcept
+				: m_pchBegin(pchBegin)
+				, m_pchEnd(pchEnd)
+			{}
+
+			// Returns false for positions which do not produce a token: colons, commas and opening quotes.
+			bool next(Char const* const pch, tc::json_token<Char>& token) & THROW(tc::json_parse_exception) {
+				if( m_pchString ) {
+					if( '"' != code(*pch) ) error(pch); // control character inside string
+					token = {m_bKey ? tc::ejsontokenKEY : tc::ejsontokenSTRING, tc::make_iterator_range(m_pchString + 1, pch), false};
+					token.m_bEscaped = tc::find_first<tc::return_bool>(token.m_str, tc::explicit_cast<Char>('\\'));
+					m_pchString = nullptr;
+					m_eexpect = m_bKey ? eexpectCOLON : after_value();
+					return true;
+				}
+				switch( code(*pch) ) {
+					case '{':
+						expect_value(pch);
+						tc::cont_emplace_back(m_vecbObject, true);
+						m_eexpect = eexpectKEYORENDOBJECT;
+						token = {tc::ejsontokenBEGINOBJECT, tc::make_iterator_range(pch, pch + 1), false};
+						return true;
+					case '[':
+						expect_value(pch);
+						tc::cont_emplace_back(m_vecbObject, false);
+						m_eexpect = eexpectVALUEORENDARRAY;
+						token = {tc::ejsontokenBEGINARRAY, tc::make_iterator_range(pch, pch + 1), false};
+						return true;
+					case '}':
+						if( !(eexpectKEYORENDOBJECT == m_eexpect || (eexpectCOMMAOREND == m_eexpect && tc::back(m_vecbObject))) ) error(pch);
+						m_vecbObject.pop_back();
+						m_eexpect = after_value();
+						token = {tc::ejsontokenENDOBJECT, tc::make_iterator_range(pch, pch + 1), false};
+						return true;
+					case ']':
+						if( !(eexpectVALUEORENDARRAY == m_eexpect || (eexpectCOMMAOREND == m_eexpect && !tc::back(m_vecbObject))) ) error(pch);
+						m_vecbObject.pop_back();
+						m_eexpect = after_value();
+						token = {tc::ejsontokenENDARRAY, tc::make_iterator_range(pch, pch + 1), false};
+						return true;
+					case ':':
+						if( eexpectCOLON != m_eexpect ) error(pch);
+						m_eexpect = eexpectVALUE;
+						return false;
+					case ',':
+						if( eexpectCOMMAOREND != m_eexpect ) error(pch);
+						m_eexpect = tc::back(m_vecbObject) ? eexpectKEY : eexpectVALUE;
+						return false;
+					case '"':
+						m_bKey = eexpectKEY == m_eexpect || eexpectKEYORENDOBJECT == m_eexpect;
+						if( !m_bKey ) expect_value(pch);
+						m_pchString = pch;
+						return false;
+					default: {
+						expect_value(pch);
+						auto ejsontoken = tc::ejsontokenNUMBER;
+						Char const* pchScalarEnd;
+						switch( code(*pch) ) {
+							case 't': ejsontoken = tc::ejsontokenTRUELITERAL; pchScalarEnd = parse_literal(pch, m_pchEnd, "true"); break;
+							case 'f': ejsontoken = tc::ejsontokenFALSELITERAL; pchScalarEnd = parse_literal(pch, m_pchEnd, "false"); break;
+							case 'n': ejsontoken = tc::ejsontokenNULLLITERAL; pchScalarEnd = parse_literal(pch, m_pchEnd, "null"); break;
+							default: pchScalarEnd = parse_number(pch, m_pchEnd); break;
+						}
+						if( !pchScalarEnd ) error(pch);
+						if( pchScalarEnd != m_pchEnd && 0 == (c_anClass[code(*pchScalarEnd)] & (c_nClassOperator | c_nClassWhitespace)) ) error(pchScalarEnd);
+						m_eexpect = after_value();
+						token = {ejsontoken, tc::make_iterator_range(pch, pchScalarEnd), false};
+						return true;
+					}
+				}
+			}
+
+			void finish() const& THROW(tc::json_parse_exception) {
+				if( m_pchString ) error(m_pchString); // unterminated string
+				if( eexpectDONE != m_eexpect ) error(m_pchEnd);
+			}
+
+		private:
+			[[noreturn]] void error(Char const* const pch) const& THROW(tc::json_parse_exception) {
+				throw tc::json_parse_exception{tc::explicit_cast<std::size_t>(pch - m_pchBegin)};
+			}
+
+			void expect_value(Char const* const pch) const& THROW(tc::json_parse_exception) {
+				if( eexpectVALUE != m_eexpect && eexpectVALUEORENDARRAY != m_eexpect ) error(pch);
+			}
+
+			EExpect after_value() const& noexcept {
+				return tc::empty(m_vecbObject) ? eexpectDONE : eexpectCOMMAOREND;
+			}
+
+			Char const* m_pchBegin;
+			Char const* m_pchEnd;
+			tc::vector<bool> m_vecbObject; // enclosing containers, true for objects
+			EExpect m_eexpect = eexpectVALUE;
+			Char const* m_pchString = nullptr; // opening quote of the current string
+			bool m_bKey = false;
+		};
+	}
+
+	namespace json_tokens_adl {
+		template<typename Rng>
+		struct [[nodiscard]] json_tokens_impl final : private tc::range_adaptor_base_range<Rng> {
+		private:
+			using char_t = tc::range_value_t<Rng>;
+			static_assert( 1 == sizeof(char_t) && tc::contiguous_range<Rng const&>, "json_tokens expects UTF-8 in contiguous memory" );
+		public:
+			friend auto range_output_t_impl(json_tokens_impl const&) -> tc::type::list<tc::json_token<char_t> const&>; // declaration only
+			using tc::range_adaptor_base_range<Rng>::range_adaptor_base_range;
+
+			template<typename Sink>
+			auto operator()(Sink&& sink) const& THROW(tc::json_parse_exception) {
+				using result_t = tc::common_type_t<decltype(tc::continue_if_not_break(sink, std::declval<tc::json_token<char_t> const&>())), tc::constant<tc::continue_>>;
+				char_t const* const pchBegin = tc::ptr_begin(this->base_range());
+				char_t const* const pchEnd = tc::ptr_end(this->base_range());
+				json_detail::structural_indexer indexer;
+				json_detail::tokenizer<char_t> tokenizer(pchBegin, pchEnd);
+				tc::json_token<char_t> token;
+				auto const Block = [&](unsigned char const* const pb, char_t const* const pchBlock) MAYTHROW -> result_t {
+					for( std::uint64_t nStructural = indexer.next(json_detail::classify(pb)); 0 != nStructural; nStructural &= nStructural - 1 ) {
+						if( tokenizer.next(pchBlock + tc::index_of_least_significant_bit(nStructural), token) ) { // THROW(tc::json_parse_exception)
+							tc_yield(sink, tc::as_const(token)); // MAYTHROW
+						}
+					}
+					return tc::constant<tc::continue_>();
+				};
+				char_t const* pch = pchBegin;
+				for( ; tc::explicit_cast<std::ptrdiff_t>(json_detail::c_nBlockSize) <= pchEnd - pch; pch += json_detail::c_nBlockSize ) {
+					tc_return_if_break(Block(reinterpret_cast<unsigned char const*>(pch), pch)) // MAYTHROW
+				}
+				if( pch != pchEnd ) {
+					// pad the last block with whitespace, which is never structural
+					std::array<unsigned char, json_detail::c_nBlockSize> ab;
+					ab.fill(' ');
+					std::memcpy(ab.data(), pch, tc::explicit_cast<std::size_t>(pchEnd - pch));
+					tc_return_if_break(Block(ab.data(), pch)) // MAYTHROW
+				}
+				tokenizer.finish(); // THROW(tc::json_parse_exception)
+				return tc::implicit_cast<result_t>(tc::constant<tc::continue_>());
+			}
+		};
+	}
+
+	// Tokens of the JSON document in the contiguous UTF-8 range rng. Iterating throws tc::json_parse_exception on syntax errors.
+	// Escape sequences inside strings are checked when unescaping them.
+	template<typename Rng>
+	auto json_tokens(Rng&& rng) return_ctor_noexcept(
+		TC_FWD(json_tokens_adl::json_tokens_impl<Rng>),
+		(aggregate_tag, std::forward<Rng>(rng))
+	)
+
+	// Writes a JSON document to a sink, e.g., tc::appender(str), and inserts commas and colons. Strings are escaped with
+	// tc::json_escape and passed to the sink in chunks. The sink must not break.
+	//   tc::json_writer writer(tc::appender(str));
+	//   writer.begin_object(); writer.key("n"); writer.value(1); writer.end_object();
+	template<typename Sink>
+	struct json_writer final {
+		explicit json_writer(Sink sink) noexcept : m_sink(tc_move(sink)) {}
+
+		void begin_object() & MAYTHROW {
+			begin_container('{', true); // MAYTHROW
+		}
+		void end_object() & MAYTHROW {
+			end_container('}', true); // MAYTHROW
+		}
+		void begin_array() & MAYTHROW {
+			begin_container('[', false); // MAYTHROW
+		}
+		void end_array() & MAYTHROW {
+			end_container(']', false); // MAYTHROW
+		}
+
+		template<typename Rng>
+		void key(Rng const& rng) & MAYTHROW {
+			_ASSERT( !tc::empty(m_vecbObject) && tc::back(m_vecbObject) && !m_bAfterKey );
+			if( !m_bFirst ) emit(",");
+			emit("\"");
+			emit(tc::json_escape(rng));
+			emit("\":"); // MAYTHROW
+			m_bAfterKey = true;
+		}
+
+		// Writes a string for ranges, true or false for bool, null for nullptr, and a number for arithmetic types.
+		// Non-finite floating point numbers, which JSON cannot represent, are written as null, like JSON.stringify does.
+		template<typename T>
+		void value(T const& t) & MAYTHROW {
+			before_value();
+			if constexpr( std::is_same<T, bool>::value ) {
+				emit(t ? "true" : "false");
+			} else if constexpr( std::is_same<T, std::nullptr_t>::value ) {
+				emit("null");
+			} else if constexpr( std::is_floating_point<T>::value ) {
+				if( std::isfinite(t) ) {
+					emit(tc::as_dec(t));
+				} else {
+					emit("null");
+				}
+			} else if constexpr( std::is_arithmetic<T>::value ) {
+				emit(tc::as_dec(t));
+			} else {
+				emit("\"");
+				emit(tc::json_escape(t));
+				emit("\""); // MAYTHROW
+			}
+			after_value();
+		}
+
+		// Writes rng unchanged, e.g., a number token of tc::json_tokens.
+		template<typename Rng>
+		void raw_value(Rng const& rng) & MAYTHROW {
+			before_value();
+			emit(rng); // MAYTHROW
+			after_value();
+		}
+
+		// The document is complete.
+		bool done() const& noexcept {
+			return tc::empty(m_vecbObject) && !m_bFirst;
+		}
+
+	private:
+		template<typename Rng>
+		void emit(Rng const& rng) & MAYTHROW {
+			tc::for_each(rng, m_sink); // MAYTHROW
+		}
+		void emit(char const* const sz) & MAYTHROW {
+			emit(std::string_view(sz)); // MAYTHROW
+		}
+
+		void before_value() & MAYTHROW {
+			if( tc::empty(m_vecbObject) ) {
+				_ASSERT( m_bFirst ); // only one top-level value
+			} else if( tc::back(m_vecbObject) ) {
+				_ASSERT( m_bAfterKey );
+			} else if( !m_bFirst ) {
+				emit(","); // MAYTHROW
+			}
+		}
+
+		void after_value() & noexcept {
+			m_bFirst = false;
+			m_bAfterKey = false;
+		}
+
+		void begin_container(char const ch, bool const bObject) & MAYTHROW {
+			before_value(); // MAYTHROW
+			tc::cont_emplace_back(m_vecbObject, bObject);
+			emit(std::string_view(&ch, 1)); // MAYTHROW
+			m_bFirst = true;
+			m_bAfterKey = false;
+		}
+
+		void end_container(char const ch, bool const bObject) & MAYTHROW {
+			_ASSERT( !tc::empty(m_vecbObject) && bObject == tc::back(m_vecbObject) && !m_bAfterKey );
+			m_vecbObject.pop_back();
+			emit(std::string_view(&ch, 1)); // MAYTHROW
+			after_value();
+		}
+
+		Sink m_sink;
+		tc::vector<bool> m_vecbObject; // enclosing containers, true for objects
+		bool m_bFirst = true; // no value yet in the innermost container, or in the document
+		bool m_bAfterKey = false;
+	};
+}
@@ -0,0 +1,161 @@
+
+// think-cell public library
+//
+// Copyright (C) 2016-2023 think-cell Software GmbH
+//
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt
+
+#include "../base/assert_defs.h"
+#include "../unittest.h"
+#include "../algorithm/append.h"
+#include "../container/string.h"
+#include "json.h"
+
+#include <random>
+
+namespace {
+	// Tokens as one string per token, prefixed with the token kind, to compare them easily.
+	template<typename Rng>
+	tc::vector<tc::string<char>> tokens(Rng const& rng) noexcept {
+		tc::vector<tc::string<char>> vecstr;
+		tc::for_each(tc::json_tokens(rng), [&](tc::json_token<char> const& token) noexcept {
+			auto str = tc::make_str<char>(tc::as_dec(tc::to_underlying(token.m_ejsontoken)), token.m_bEscaped ? "\\" : ":");
+			tc::append(str, token.m_str);
+			tc::cont_emplace_back(vecstr, tc_move(str));
+		});
+		return vecstr;
+	}
+
+	template<typename Rng>
+	std::optional<std::size_t> parse_error(Rng const& rng) noexcept {
+		try {
+			tc::for_each(tc::json_tokens(rng), tc::noop());
+			return std::nullopt;
+		} catch( tc::json_parse_exception const& e ) {
+			return e.m_nPosition;
+		}
+	}
+}
+
+UNITTESTDEF(json_tokens) {
+	tc::vector<tc::EJsonToken> vecejsontoken;
+	tc::vector<tc::string<char>> vecstr;
+	tc::for_each(tc::json_tokens(" {\"a\": [1, -2.5e+3, true, false, null, \"x\\\"y\"], \"b\" : {}, \"c\":[]}\n"), [&](tc::json_token<char> const& token) noexcept {
+		tc::cont_emplace_back(vecejsontoken, token.m_ejsontoken);
+		tc::cont_emplace_back(vecstr, tc::make_str<char>(token.m_str));
+	});
+	_ASSERT( tc::equal(vecejsontoken, tc::make_vector(std::initializer_list<tc::EJsonToken>{
+		tc::ejsontokenBEGINOBJECT, tc::ejsontokenKEY, tc::ejsontokenBEGINARRAY, tc::ejsontokenNUMBER, tc::ejsontokenNUMBER,
+		tc::ejsontokenTRUELITERAL, tc::ejsontokenFALSELITERAL, tc::ejsontokenNULLLITERAL, tc::ejsontokenSTRING, tc::ejsontokenENDARRAY,
+		tc::ejsontokenKEY, tc::ejsontokenBEGINOBJECT, tc::ejsontokenENDOBJECT, tc::ejsontokenKEY, tc::ejsontokenBEGINARRAY, tc::ejsontokenENDARRAY,
+		tc::ejsontokenENDOBJECT
+	})) );
+	_ASSERT( tc::equal(vecstr, tc::make_vector(std::initializer_list<tc::string<char>>{
+		"{", "a", "[", "1", "-2.5e+3", "true", "false", "null", "x\\\"y", "]", "b", "{", "}", "c", "[", "]", "}"
+	})) );
+
+	_ASSERTEQUAL( tc::size(tokens("42")), 1 );
+	_ASSERTEQUAL( tc::size(tokens("\"\"")), 1 );
+	tc::for_each(tc::json_tokens("\"a\\u00e4\\n\""), [](tc::json_token<char> const& token) noexcept {
+		_ASSERT( token.m_bEscaped );
+		_ASSERT( tc::equal(tc::make_str<char>(tc::json_unescape(token.m_str)), "a\xc3\xa4\n") );
+	});
+	_ASSERT( tc::equal(tokens("[\"ab\"]"), tc::make_vector(std::initializer_list<tc::string<char>>{"2:[", "5:ab", "3:]"})) );
+}
+
+UNITTESTDEF(json_tokens_errors) {
+	_ASSERTEQUAL( parse_error(""), 0 );
+	_ASSERTEQUAL( parse_error("  "), 2 );
+	_ASSERTEQUAL( parse_error("[1,]"), 3 );
+	_ASSERTEQUAL( parse_error("[1 2]"), 3 );
+	_ASSERTEQUAL( parse_error("{\"a\" 1}"), 5 );
+	_ASSERTEQUAL( parse_error("{1:2}"), 1 );
+	_ASSERTEQUAL( parse_error("{\"a\":1]"), 6 );
+	_ASSERTEQUAL( parse_error("[1}"), 2 );
+	_ASSERTEQUAL( parse_error("[1"), 2 );
+	_ASSERTEQUAL( parse_error("1 2"), 2 );
+	_ASSERTEQUAL( parse_error("[\"abc]"), 1 );
+	_ASSERTEQUAL( parse_error("[\"a\tb\"]"), 3 );
+	_ASSERTEQUAL( parse_error("[01]"), 2 );
+	_ASSERTEQUAL( parse_error("[1.]"), 1 );
+	_ASSERTEQUAL( parse_error("[-]"), 1 );
+	_ASSERTEQUAL( parse_error("[1e]"), 1 );
+	_ASSERTEQUAL( parse_error("[tru]"), 1 );
+	_ASSERTEQUAL( parse_error("[truex]"), 5 );
+	_ASSERTEQUAL( parse_error("[1\"x\"]"), 2 );
+	_ASSERTEQUAL( parse_error("[\"x\"1]"), 4 );
+	_ASSERTEQUAL( parse_error("[\x01]"), 1 );
+	_ASSERT( !parse_error("[\"\\\\\"]") );
+}
+
+UNITTESTDEF(json_tokens_block_boundaries) {
+	// Backslash runs, quotes and scalars straddling the 64-byte blocks must not depend on the position in the input.
+	std::mt19937 rng(7);
+	for( int nDocument = 0; nDocument < 50; ++nDocument ) {
+		tc::string<char> strDocument = "[";
+		for( int nValue = 0; nValue < 10; ++nValue ) {
+			if( 0 < nValue ) tc::append(strDocument, ",");
+			switch( rng() % 3 ) {
+				case 0: {
+					tc::append(strDocument, "\"");
+					for( unsigned int n = rng() % 20; 0 < n; --n ) {
+						tc::append(strDocument, 0 == rng() % 3 ? tc::make_str<char>(tc::repeat_n(2 * (rng() % 3) + 1, '\\'), "\"") : tc::make_str<char>(tc::repeat_n(1 + rng() % 5, 'x')));
+					}
+					tc::append(strDocument, "\"");
+					break;
+				}
+				case 1:
+					tc::append(strDocument, tc::as_dec(rng()));
+					break;
+				default:
+					tc::append(strDocument, "{\"k\\\\\":null}");
+			}
+		}
+		tc::append(strDocument, "]");
+		auto const vecstrExpected = tokens(strDocument);
+		for( std::size_t nOffset = 1; nOffset < 70; ++nOffset ) {
+			_ASSERT( tc::equal(tokens(tc::make_str<char>(tc::repeat_n(nOffset, ' '), strDocument)), vecstrExpected) );
+		}
+	}
+}
+
+UNITTESTDEF(json_writer) {
+	tc::string<char> str;
+	tc::json_writer writer(tc::appender(str));
+	writer.begin_object();
+	writer.key("name");
+	writer.value("a \"quoted\"\nline");
+	writer.key("values");
+	writer.begin_array();
+	writer.value(1);
+	writer.value(-2.5);
+	writer.value(true);
+	writer.value(nullptr);
+	writer.value(std::numeric_limits<double>::infinity());
+	writer.begin_object();
+	writer.end_object();
+	writer.end_array();
+	writer.end_object();
+	_ASSERT( writer.done() );
+	_ASSERT( tc::equal(str, "{\"name\":\"a \\\"quoted\\\"\\nline\",\"values\":[1,-2.5,true,null,null,{}]}") );
+
+	// write the tokens back
+	tc::string<char> strCopy;
+	tc::json_writer writerCopy(tc::appender(strCopy));
+	tc::for_each(tc::json_tokens(str), [&](tc::json_token<char> const& token) noexcept {
+		switch_no_default( token.m_ejsontoken ) {
+			case tc::ejsontokenBEGINOBJECT: writerCopy.begin_object(); break;
+			case tc::ejsontokenENDOBJECT: writerCopy.end_object(); break;
+			case tc::ejsontokenBEGINARRAY: writerCopy.begin_array(); break;
+			case tc::ejsontokenENDARRAY: writerCopy.end_array(); break;
+			case tc::ejsontokenKEY: writerCopy.key(tc::make_str<char>(tc::json_unescape(token.m_str))); break;
+			case tc::ejsontokenSTRING: writerCopy.value(tc::make_str<char>(tc::json_unescape(token.m_str))); break;
+			case tc::ejsontokenNUMBER: writerCopy.raw_value(token.m_str); break;
+			case tc::ejsontokenTRUELITERAL: writerCopy.value(true); break;
+			case tc::ejsontokenFALSELITERAL: writerCopy.value(false); break;
+			case tc::ejsontokenNULLLITERAL: writerCopy.value(nullptr); break;
+		}
+	});
+	_ASSERT( tc::equal(strCopy, str) );
+}
@@ -11,8 +11,113 @@
 #include "../base/assert_defs.h"
 #include "../base/generic_macros.h"
 #include "../algorithm/append.h"
+#include "../container/cont_reserve.h"
+#include "../container/insert.h"
+#include "../container/string.h"
+
+#include <algorithm>
+#include <array>
 
 namespace tc {
+	namespace make_c_str_detail {
+		// Strings shorter than this, in code units, are built inside the make_c_str result instead of on the heap.
+		inline constexpr std::size_t c_nInlineCapacity = 256;
+
+		// The size of Rng is the number of code units appended only if no encoding conversion is needed.
+		template< typename Rng, typename Char >
+		concept sized_range_of = tc::has_size<Rng> && std::is_same<std::remove_cv_t<tc::range_value_t<Rng>>, Char>::value;
+	}
+
+	namespace no_adl {
+		// Null-terminated string with inline storage for short strings, which falls back to the heap for longer ones.
+		// Provides the container interface needed by tc::appender.
+		template< typename Char, std::size_t nInline = make_c_str_detail::c_nInlineCapacity >
+		struct [[nodiscard]] c_str_buffer final {
+			static_assert( 0 < nInline );
+			using value_type = Char;
+			using iterator = Char*;
+			using const_iterator = Char const*;
+
+			template< typename... Rng >
+			explicit c_str_buffer(Rng&&... rng) MAYTHROW {
+				m_achInline[0] = Char();
+				if constexpr( (make_c_str_detail::sized_range_of<Rng, Char> && ...) ) {
+					reserve((tc::size_raw(rng) + ... + 0)); // MAYTHROW
+				}
+				(tc::for_each(std::forward<Rng>(rng), tc::appender(*this)), ...); // MAYTHROW
+			}
+
+			Char* data() & noexcept {
+				return m_bHeap ? tc::ptr_begin(m_strHeap) : m_achInline.data();
+			}
+			Char const* data() const& noexcept {
+				return m_bHeap ? tc::ptr_begin(m_strHeap) : m_achInline.data();
+			}
+			Char* begin() & noexcept { return data(); }
+			Char const* begin() const& noexcept { return data(); }
+			Char* end() & noexcept { return data() + m_n; }
+			Char const* end() const& noexcept { return data() + m_n; }
+			std::size_t size() const& noexcept { return m_n; }
+
+			void reserve(std::size_t const n) & MAYTHROW {
+				if( nInline <= n ) {
+					move_to_heap(n); // MAYTHROW
+				}
+			}
+
+			void emplace_back(Char const ch) & MAYTHROW {
+				if( !m_bHeap && m_n + 1 < nInline ) {
+					m_achInline[m_n] = ch;
+					m_achInline[m_n + 1] = Char();
+				} else {
+					move_to_heap(2 * nInline); // MAYTHROW
+					tc::cont_emplace_back(m_strHeap, ch); // MAYTHROW
+				}
+				++m_n;
+			}
+
+			template< typename It >
+			void insert(Char const* const itPos, It const itBegin, It const itEnd) & MAYTHROW {
+				_ASSERTEQUAL( itPos, end() );
+				auto const n = tc::explicit_cast<std::size_t>(itEnd - itBegin);
+				if( !m_bHeap && m_n + n < nInline ) {
+					std::copy(itBegin, itEnd, m_achInline.data() + m_n);
+					m_achInline[m_n + n] = Char();
+				} else {
+					move_to_heap(m_n + n); // MAYTHROW
+					tc::append(m_strHeap, tc::make_iterator_range(itBegin, itEnd)); // MAYTHROW
+				}
+				m_n += n;
+			}
+
+		private:
+			void move_to_heap(std::size_t const nCapacity) & MAYTHROW {
+				if( !m_bHeap ) {
+					tc::cont_reserve(m_strHeap, nCapacity); // MAYTHROW
+					tc::append(m_strHeap, tc::counted(m_achInline.data(), m_n)); // MAYTHROW
+					m_bHeap = true;
+				} else {
+					tc::cont_reserve(m_strHeap, nCapacity); // MAYTHROW
+				}
+			}
+
+			std::size_t m_n = 0;
+			bool m_bHeap = false;
+			std::array<Char, nInline> m_achInline;
+			tc::string<Char> m_strHeap;
+		};
+	}
+
+	template< typename Char, std::size_t nInline >
+	[[nodiscard]] Char const* as_c_str(no_adl::c_str_buffer<Char, nInline> const& str) noexcept {
+		return str.data();
+	}
+
+	template< typename Char, std::size_t nInline >
+	[[nodiscard]] Char* as_c_str(no_adl::c_str_buffer<Char, nInline>& str) noexcept {
+		return str.data();
+	}
+
 	namespace no_adl {
 		template< typename Char, typename Rng, typename Enable = void >
 		struct has_convertible_as_c_str final
@@ -26,6 +131,9 @@ namespace tc {
 		struct [[nodiscard]] make_c_str_impl final {
 			explicit make_c_str_impl(Str&& str) noexcept: m_str(std::forward<Str>(str)) {}
 
+			template< typename... Args >
+			explicit make_c_str_impl(tc::aggregate_tag_t, Args&&... args) MAYTHROW: m_str(std::forward<Args>(args)...) {}
+
 			// We don't want make_c_str_impl to be able to implicitly cast to bool. Deleting operator bool() won't work because
 			// a deleted function is still considered in overload resolution and will cause ambiguity between foo(bool) and foo(char const*).
 			template<typename T> requires std::is_same<T, Char const*>::value
@@ -50,7 +158,8 @@ namespace tc {
 	//  make_c_str(<Char>): create a value or reference holder which is castable to c string
 
 	//   1. One input range, tc::as_c_str(rng) is valid and convertible to Char const*: hold the value or reference of the rng, castable to tc::as_c_str(rng)
-	//   2. Otherwise: create and hold a tc::string<Char>, castable to Char const*
+	//   2. Otherwise: create and hold the string, in place up to make_c_str_detail::c_nInlineCapacity code units including the terminator,
+	//      otherwise on the heap, castable to Char const*
 	//   3. Explicitly specified <Char> could be omitted if the char pointer type deduced from the first rng is convertible to destination c string
 	//   4. make_mutable_c_str(<Char>): create a value or reference holder which is castable to mutable c string
 
@@ -68,7 +177,7 @@ namespace tc {
 	template< typename Char, typename Rng0, typename... Rng >
 	auto make_c_str(Rng0&& rng0, Rng&& ... rng) MAYTHROW {
 		static_assert(tc::decayed<Char>);
-		return tc::no_adl::make_c_str_impl<Char const, tc::string<Char>>(tc::make_str<Char>(std::forward<Rng0>(rng0), std::forward<Rng>(rng)...));
+		return tc::no_adl::make_c_str_impl<Char const, tc::no_adl::c_str_buffer<Char>>(tc::aggregate_tag, std::forward<Rng0>(rng0), std::forward<Rng>(rng)...);
 	}
 
 	template< typename Rng0, typename... Rng >
@@ -90,7 +199,7 @@ namespace tc {
 	template< typename Char, typename Rng0, typename... Rng >
 	auto make_mutable_c_str(Rng0&& rng0, Rng&& ... rng) MAYTHROW {
 		static_assert(tc::decayed<Char>);
-		return tc::no_adl::make_c_str_impl<Char, tc::string<Char>>(tc::make_str<Char>(std::forward<Rng0>(rng0), std::forward<Rng>(rng)...));
+		return tc::no_adl::make_c_str_impl<Char, tc::no_adl::c_str_buffer<Char>>(tc::aggregate_tag, std::forward<Rng0>(rng0), std::forward<Rng>(rng)...);
 	}
 
 	template< typename Rng0, typename... Rng >
@@ -9,6 +9,7 @@
 #include "../base/assert_defs.h"
 #include "../unittest.h"
 
+#include "../range/filter_adaptor.h"
 #include "make_c_str.h"
 
 #ifdef TC_PRIVATE
@@ -67,3 +68,45 @@ UNITTESTDEF(make_c_str_test) {
 #endif
 }
 
+
+namespace {
+	template<typename Char = char, typename Str>
+	bool is_inline(Str const& str) noexcept {
+		auto const* const pch = reinterpret_cast<unsigned char const*>(tc::implicit_cast<Char const*>(str));
+		auto const* const pbyte = reinterpret_cast<unsigned char const*>(std::addressof(str));
+		return pbyte <= pch && pch < pbyte + sizeof(Str);
+	}
+}
+
+UNITTESTDEF(make_c_str_inline_test) {
+	auto const strShort = tc::make_c_str<char>("ab", tc::string<char>("cd"), "ef");
+	_ASSERT(check_make_c_str<char>(strShort, "abcdef"));
+	_ASSERT(is_inline(strShort));
+
+	auto const strEmpty = tc::make_c_str<char>("", "");
+	_ASSERT(check_make_c_str<char>(strEmpty, ""));
+
+	tc::string<char> const strLong(tc::make_c_str_detail::c_nInlineCapacity, 'x');
+	auto const strLongConcat = tc::make_c_str<char>("a", strLong);
+	_ASSERT(check_make_c_str<char>(strLongConcat, tc::concat("a", strLong)));
+	_ASSERT(!is_inline(strLongConcat));
+
+	// The size of filtered ranges is unknown, so the string moves to the heap when the inline buffer is full.
+	auto const IsX = [](char ch) noexcept { return 'x' == ch; };
+	for( std::size_t n : {tc::make_c_str_detail::c_nInlineCapacity - 2, tc::make_c_str_detail::c_nInlineCapacity - 1, tc::make_c_str_detail::c_nInlineCapacity} ) {
+		auto const str = tc::make_c_str<char>("<", tc::filter(tc::begin_next<tc::return_take>(strLong, n), IsX));
+		_ASSERT(check_make_c_str<char>(str, tc::concat("<", tc::begin_next<tc::return_take>(strLong, n))));
+		_ASSERTEQUAL(is_inline(str), n + 1 < tc::make_c_str_detail::c_nInlineCapacity);
+	}
+
+	// The UTF-8 string is longer than the inline buffer in bytes, but not in UTF-16 code units.
+	tc::string<char> strUtf8;
+	for( std::size_t i = 0; i < tc::make_c_str_detail::c_nInlineCapacity / 2; ++i ) tc::append(strUtf8, "\xC3\xA4");
+	auto const strUtf16 = tc::make_c_str<tc::char16>(u"<", strUtf8);
+	_ASSERT(is_inline<tc::char16>(strUtf16));
+	_ASSERT(check_make_c_str<tc::char16>(strUtf16, tc::concat(u"<", tc::convert_enc<tc::char16>(strUtf8))));
+
+	auto strMutable = tc::make_mutable_c_str<char>("ab", "cd");
+	tc::implicit_cast<char*>(strMutable)[0] = 'x';
+	_ASSERT(check_make_c_str<char>(strMutable, "xbcd"));
+}
@@ -23,6 +23,9 @@
 
 #include <boost/version.hpp>
 
+#include <array>
+#include <cstdint>
+
 #ifndef __clang__
 MODIFY_WARNINGS_BEGIN(
 	((disable)(4127)) // conditional expression is constant
@@ -165,24 +168,61 @@ namespace tc {
 		return {ch};
 	}
 
+	namespace char_set_detail {
+		template<tc::char_type Char>
+		constexpr auto char_code(Char const ch) noexcept {
+			return static_cast<std::make_unsigned_t<Char>>(ch);
+		}
+
+		template<tc::char_type T, T tFirst, T tLast>
+		constexpr auto char_code(tc::value_restrictive<T, tFirst, tLast> const ch) noexcept {
+			return char_code(static_cast<T>(ch));
+		}
+	}
+
 	namespace no_adl {
+		// Characters below 256 are looked up in a 256-bit bitmap built on construction, i.e., at compile time for constexpr sets.
+		// Only characters of wider character types outside this table fall back to scanning the set.
 		template<typename Rng>
 		struct char_set final: x3::char_parser<char_set<Rng>> {
 			using attribute_type = tc::range_value_t<Rng>;
 			static bool const has_attribute = true;
 
 			constexpr char_set(Rng rng) noexcept
-				: m_rng(tc_move_if_owned(rng)) {}
+				: m_rng(tc_move_if_owned(rng))
+			{
+				tc::for_each(m_rng, [&](auto const& ch) noexcept {
+					auto const nCode = char_set_detail::char_code(ch);
+					if( nCode < 256 ) {
+						m_anBitmap[nCode / 64] |= std::uint64_t(1) << (nCode % 64);
+					} else {
+						m_bWide = true;
+					}
+				});
+			}
+
+			constexpr bool contains(attribute_type const& ch) const& noexcept {
+				auto const nCode = char_set_detail::char_code(ch);
+				if( nCode < 256 ) {
+					return 0 != (m_anBitmap[nCode / 64] & (std::uint64_t(1) << (nCode % 64)));
+				} else {
+					return m_bWide && tc::any_of(m_rng, [&](auto const& chAllowed) noexcept { return chAllowed == ch; });
+				}
+			}
 
 			template <typename CharType, typename Context>
 			bool test(CharType const& ch, Context& context) const& noexcept {
 				static_assert( std::is_same<CharType, attribute_type>::value );
-				return tc::any_of(m_rng, [&](auto const& chAllowed) noexcept {
-					return 0==x3::get_case_compare<tc::char_encoding<CharType>>(context)(ch, chAllowed);
-				});
+				static_assert(
+					std::is_same<decltype(x3::get_case_compare<tc::char_encoding<CharType>>(context)), x3::case_compare<tc::char_encoding<CharType>>>::value,
+					"tc::char_encoding does not support x3::no_case"
+				);
+				return contains(ch);
 			}
 		private:
 			tc::decay_t<Rng> m_rng;
+			std::array<std::uint64_t, 4> m_anBitmap = {};
+			bool m_bWide = false;
 		};
 	}
 
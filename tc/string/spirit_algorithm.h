@@ -69,6 +69,18 @@ namespace tc {
 		return RangeReturn::pack_no_element(std::forward<Rng>(rng));
 	}
 
+	// Finds the first character in / not in a tc::static_char_class, e.g., to skip runs of accepted characters in one loop
+	// instead of one parser invocation per character. Each test is a bitmap lookup.
+	template<typename RangeReturn, typename Rng, typename RngCharSet>
+	[[nodiscard]] constexpr decltype(auto) find_first_of(Rng&& rng, no_adl::char_set<RngCharSet> const& charset) noexcept {
+		return tc::find_first_if<RangeReturn>(std::forward<Rng>(rng), [&](auto const& ch) noexcept { return charset.contains(ch); });
+	}
+
+	template<typename RangeReturn, typename Rng, typename RngCharSet>
+	[[nodiscard]] constexpr decltype(auto) find_first_not_of(Rng&& rng, no_adl::char_set<RngCharSet> const& charset) noexcept {
+		return tc::find_first_if<RangeReturn>(std::forward<Rng>(rng), [&](auto const& ch) noexcept { return !charset.contains(ch); });
+	}
+
 	template<typename RangeReturn, typename RngWhere, typename What>
 	decltype(auto) search_unique(RngWhere&& rngWhere, What const& what) noexcept {
 		if(auto const orng=tc::search_first<tc::return_view_or_none>(rngWhere, what)) {